@@ -0,0 +1,86 @@
+#include "OrderBook.hpp"
+#include "mocks/MockDatabase.hpp"
+#include "mocks/MockRiskService.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+static Order makeRestingOrder(int id, std::mt19937 &rng)
+{
+    auto side = (id % 2 == 0) ? OrderSide::BID : OrderSide::ASK;
+    double price = (side == OrderSide::BID) ? 90.0 + rng() % 100 / 10.0 : 101.0 + rng() % 100 / 10.0;
+    LimitOrder order(side, 10, "Trader" + std::to_string(id % 64), price);
+    order.setId(id);
+    return order;
+}
+
+// Cancels a random resting order and replaces it, so the book depth stays fixed across iterations.
+static void BM_QueueManagerCancel(benchmark::State &state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    std::mt19937 rng(42);
+
+    OrderQueueManager orderQueueManager;
+    std::vector<int> restingIds;
+    for (int id = 1; id <= depth; ++id)
+    {
+        orderQueueManager.addOrder(makeRestingOrder(id, rng));
+        restingIds.push_back(id);
+    }
+
+    int nextId = depth + 1;
+    for (auto _ : state)
+    {
+        size_t slot = rng() % restingIds.size();
+        orderQueueManager.removeOrder(restingIds[slot]);
+
+        state.PauseTiming();
+        orderQueueManager.addOrder(makeRestingOrder(nextId, rng));
+        restingIds[slot] = nextId++;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueueManagerCancel)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_OrderBookCancel(benchmark::State &state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    std::mt19937 rng(42);
+
+    auto database = std::make_shared<MockDatabase>();
+    auto eventLogger = std::make_shared<EventLogger>();
+    auto traderService = std::make_shared<MockTraderService>();
+    auto riskService = std::make_shared<MockRiskService>(eventLogger, traderService);
+    auto marketService = std::make_shared<MarketService>(traderService);
+    OrderBook orderBook(database, eventLogger, marketService, riskService, traderService);
+
+    auto addRestingOrder = [&](int i)
+    {
+        auto side = (i % 2 == 0) ? OrderSide::BID : OrderSide::ASK;
+        double price = (side == OrderSide::BID) ? 90.0 + rng() % 100 / 10.0 : 101.0 + rng() % 100 / 10.0;
+        auto payload = LimitOrder(side, 10, "Trader" + std::to_string(i % 64), price);
+        return orderBook.addOrder(payload).getId();
+    };
+
+    std::vector<int> restingIds;
+    for (int i = 0; i < depth; ++i)
+        restingIds.push_back(addRestingOrder(i));
+
+    int i = depth;
+    for (auto _ : state)
+    {
+        size_t slot = rng() % restingIds.size();
+        benchmark::DoNotOptimize(orderBook.cancelOrder(restingIds[slot]));
+
+        state.PauseTiming();
+        restingIds[slot] = addRestingOrder(i++);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBookCancel)->Arg(1000)->Arg(10000)->Arg(100000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,190 @@
+#include "OrderQueueManager.hpp"
+#include "matcher/DefaultMatchingStrategy.hpp"
+#include "matcher/MatchingEngine.hpp"
+#include "mocks/MockDatabase.hpp"
+#include "mocks/MockTraderService.hpp"
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Counts allocations on every thread, including the persistence writer's in the full match benchmark.
+static std::atomic<size_t> allocationCount = 0;
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+static const int LEVELS = 10;
+static const int ORDERS_PER_LEVEL = 20;
+static const int RESTING_QUANTITY = 10;
+
+static std::vector<std::string> makeMakers()
+{
+    std::vector<std::string> makers;
+    for (int i = 0; i < 16; ++i)
+        makers.push_back("Maker" + std::to_string(i));
+    return makers;
+}
+
+static void seedAsks(OrderQueueManager &orderQueueManager, const std::vector<std::string> &makers, int &nextId)
+{
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        for (int i = 0; i < ORDERS_PER_LEVEL; ++i)
+        {
+            LimitOrder ask(OrderSide::ASK, RESTING_QUANTITY, makers[nextId % makers.size()], 101.0 + level);
+            ask.setId(nextId++);
+            orderQueueManager.addOrder(ask);
+        }
+    }
+}
+
+// Replaces the asks a sweep filled at the same prices, so the book looks the same at the start of every
+// iteration.
+static void replaceFilled(OrderQueueManager &orderQueueManager, const MatchBuffers &buffers,
+                          const std::vector<std::string> &makers, int &nextId)
+{
+    for (auto handle : buffers.updatedOrders)
+    {
+        const auto *filled = orderQueueManager.getOrder(handle);
+        if (!filled || filled->getStatus() != OrderStatus::FILLED)
+            continue;
+
+        Order replacement(OrderType::LIMIT, OrderSide::ASK, RESTING_QUANTITY, makers[nextId % makers.size()], filled->getPrice());
+        replacement.setId(nextId++);
+        orderQueueManager.releaseOrder(handle);
+        orderQueueManager.addOrder(replacement);
+    }
+}
+
+// Sweeps `ordersPerMatch` resting asks with one incoming bid. Only the crossing loop (fill) is measured:
+// it must not allocate once warm. Building trades and events afterwards does allocate, and is covered by
+// BM_FullMatchAllocations.
+static void BM_CrossingAllocations(benchmark::State &state)
+{
+    const int ordersPerMatch = static_cast<int>(state.range(0));
+    const auto makers = makeMakers();
+    const std::string taker = "Taker";
+
+    OrderQueueManager orderQueueManager;
+    DefaultMatchingStrategy strategy;
+    MatchBuffers buffers;
+    int nextId = 1;
+    seedAsks(orderQueueManager, makers, nextId);
+
+    auto matchOnce = [&]()
+    {
+        buffers.clear();
+
+        LimitOrder bid(OrderSide::BID, ordersPerMatch * RESTING_QUANTITY, taker, 101.0 + LEVELS);
+        bid.setId(nextId++);
+        auto bidHandle = orderQueueManager.storeOrder(bid);
+        strategy.fill(*orderQueueManager.getOrder(bidHandle), orderQueueManager, buffers);
+
+        replaceFilled(orderQueueManager, buffers, makers, nextId);
+        orderQueueManager.releaseOrder(bidHandle);
+        benchmark::DoNotOptimize(buffers.fills.data());
+    };
+
+    // Let the pools and buffers reach their working size before counting.
+    for (int i = 0; i < 10000; ++i)
+        matchOnce();
+
+    size_t allocationsBefore = allocationCount;
+    for (auto _ : state)
+        matchOnce();
+    size_t allocations = allocationCount - allocationsBefore;
+
+    state.counters["allocs_per_match"] = benchmark::Counter(static_cast<double>(allocations) / state.iterations());
+    state.SetItemsProcessed(state.iterations());
+    if (allocations != 0)
+        state.SkipWithError("crossing loop allocated after warm-up");
+}
+BENCHMARK(BM_CrossingAllocations)->Arg(1)->Arg(5)->Arg(50);
+
+// The same sweep through MatchingEngine::matchOrder, so each fill is also recorded as a trade, applied to
+// trader positions, queued for persistence and logged as an event. Reports what that costs in allocations
+// rather than requiring none.
+static void BM_FullMatchAllocations(benchmark::State &state)
+{
+    const int ordersPerMatch = static_cast<int>(state.range(0));
+    const auto makers = makeMakers();
+    const std::string taker = "Taker";
+
+    auto database = std::make_shared<MockDatabase>();
+    auto persistence = std::make_shared<PersistenceWriter>(database);
+    auto eventLogger = std::make_shared<EventLogger>();
+    auto traderService = std::make_shared<MockTraderService>();
+    auto marketService = std::make_shared<MarketService>(traderService);
+    TradeService tradeService(database, persistence, eventLogger, marketService, traderService);
+
+    // Makers only ever sell, so each starts with enough stock for the whole run. The taker buys a new lot
+    // with every fill, so it is put back to its starting state after each match; otherwise its position
+    // grows for the whole run and every trade costs more than the last.
+    for (const auto &maker : makers)
+    {
+        auto trader = traderService->getTrader(maker);
+        auto seeded = trader->getState();
+        seeded.lots = {{1 << 30, 100.0}};
+        trader->restoreState(seeded);
+    }
+    auto takerTrader = traderService->getTrader(taker);
+    const auto takerStart = takerTrader->getState();
+
+    OrderQueueManager orderQueueManager;
+    MatchingEngine engine;
+    MatchBuffers buffers;
+    int nextId = 1;
+    seedAsks(orderQueueManager, makers, nextId);
+
+    auto matchOnce = [&]()
+    {
+        buffers.clear();
+
+        LimitOrder bid(OrderSide::BID, ordersPerMatch * RESTING_QUANTITY, taker, 101.0 + LEVELS);
+        bid.setId(nextId++);
+        auto bidHandle = orderQueueManager.storeOrder(bid);
+        engine.matchOrder(*orderQueueManager.getOrder(bidHandle), orderQueueManager, tradeService, *eventLogger, buffers);
+
+        replaceFilled(orderQueueManager, buffers, makers, nextId);
+        orderQueueManager.releaseOrder(bidHandle);
+    };
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        matchOnce();
+        takerTrader->restoreState(takerStart);
+    }
+
+    size_t allocationsBefore = allocationCount;
+    size_t resetAllocations = 0;
+    for (auto _ : state)
+    {
+        matchOnce();
+
+        state.PauseTiming();
+        size_t resetStart = allocationCount;
+        takerTrader->restoreState(takerStart);
+        resetAllocations += allocationCount - resetStart;
+        state.ResumeTiming();
+    }
+    size_t allocations = allocationCount - allocationsBefore - resetAllocations;
+
+    state.counters["allocs_per_match"] = benchmark::Counter(static_cast<double>(allocations) / state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FullMatchAllocations)->Arg(1)->Arg(5)->Arg(50);
+
+BENCHMARK_MAIN();
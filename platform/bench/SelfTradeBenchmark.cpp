@@ -0,0 +1,68 @@
+#include "OrderQueueManager.hpp"
+#include "matcher/DefaultMatchingStrategy.hpp"
+#include "order-utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+static const int LEVELS = 10;
+static const int ORDERS_PER_LEVEL = 50;
+static const int RESTING_QUANTITY = 10;
+
+// One trader owns nine in ten resting asks and keeps sending bids into them. Each iteration replaces any
+// order that left the book, so every mode sees the same shape of book.
+static void BM_SelfTradePrevention(benchmark::State &state)
+{
+    const auto mode = static_cast<SelfTradePrevention>(state.range(0));
+    const std::string dominant = "Dominant";
+    const std::string other = "Other";
+
+    OrderQueueManager orderQueueManager;
+    DefaultMatchingStrategy strategy;
+    MatchBuffers buffers;
+    int nextId = 1;
+
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        for (int i = 0; i < ORDERS_PER_LEVEL; ++i)
+        {
+            LimitOrder ask(OrderSide::ASK, RESTING_QUANTITY, (nextId % 10 == 0) ? other : dominant, 101.0 + level);
+            ask.setId(nextId++);
+            orderQueueManager.addOrder(ask);
+        }
+    }
+
+    for (auto _ : state)
+    {
+        buffers.clear();
+
+        LimitOrder bid(OrderSide::BID, 5 * RESTING_QUANTITY, dominant, 101.0 + LEVELS);
+        bid.setId(nextId++);
+        auto bidHandle = orderQueueManager.storeOrder(bid);
+        strategy.fill(*orderQueueManager.getOrder(bidHandle), orderQueueManager, buffers, mode);
+
+        state.PauseTiming();
+        for (auto handle : buffers.updatedOrders)
+        {
+            const auto *order = orderQueueManager.getOrder(handle);
+            if (!order || isOpenOrder(*order))
+                continue;
+
+            Order replacement(OrderType::LIMIT, OrderSide::ASK, RESTING_QUANTITY, order->getTraderId(), order->getPrice());
+            replacement.setId(nextId++);
+            orderQueueManager.releaseOrder(handle);
+            orderQueueManager.addOrder(replacement);
+        }
+        orderQueueManager.releaseOrder(bidHandle);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SelfTradePrevention)
+    ->ArgName("mode")
+    ->Arg(static_cast<int>(SelfTradePrevention::SKIP))
+    ->Arg(static_cast<int>(SelfTradePrevention::CANCEL_NEWEST))
+    ->Arg(static_cast<int>(SelfTradePrevention::CANCEL_OLDEST))
+    ->Arg(static_cast<int>(SelfTradePrevention::DECREMENT_BOTH));
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+#include "database/Database.hpp"
+#include "models/Order.hpp"
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+
+// The journal runs with its default settings, syncing to disk on every commit.
+static const char *PROFILES[] = {"baseline", "wal", "fast", "journal"};
+static const int STARTUP_ORDERS = 100000;
+
+static std::string databasePath(const std::string &name)
+{
+    return (std::filesystem::temp_directory_path() / ("midas-bench-" + name + ".db")).string();
+}
+
+static void removeDatabase(const std::string &path)
+{
+    for (const char *suffix : {"", "-wal", "-shm", "-journal"})
+        std::filesystem::remove_all(path + suffix);
+}
+
+static std::shared_ptr<Database> openDatabase(const std::string &path, const std::string &profile)
+{
+    StorageOptions options;
+    if (profile == "journal")
+        options.backend = StorageBackend::JOURNAL;
+    else
+        options = StorageOptions::fromProfile(profile);
+    return Database::open(path, options);
+}
+
+static Order makeOrder(int id, std::mt19937 &rng)
+{
+    auto side = (id % 2 == 0) ? OrderSide::BID : OrderSide::ASK;
+    double price = (side == OrderSide::BID) ? 90.0 + rng() % 100 / 10.0 : 101.0 + rng() % 100 / 10.0;
+    LimitOrder order(side, 10, "Trader" + std::to_string(id % 64), price);
+    order.setId(id);
+    return order;
+}
+
+// Inserts orders in transactions of `batch` rows, as the persistence writer does. A batch of one shows the
+// cost of a commit on its own.
+static void BM_StorageInsert(benchmark::State &state)
+{
+    const char *profile = PROFILES[state.range(0)];
+    const int batch = static_cast<int>(state.range(1));
+    std::string path = databasePath(std::string("insert-") + profile);
+    removeDatabase(path);
+
+    std::mt19937 rng(42);
+    int nextId = 1;
+    {
+        auto database = openDatabase(path, profile);
+        for (auto _ : state)
+        {
+            database->beginTransaction();
+            for (int i = 0; i < batch; ++i)
+                database->orders()->insert(makeOrder(nextId++, rng));
+            database->commitTransaction();
+        }
+    }
+
+    removeDatabase(path);
+    state.SetItemsProcessed(state.iterations() * batch);
+    state.SetLabel(profile);
+}
+BENCHMARK(BM_StorageInsert)->ArgsProduct({{0, 1, 2, 3}, {1, 1000}});
+
+// Rewrites random rows of a 100k-order table, in transactions of `batch` updates.
+static void BM_StorageUpdate(benchmark::State &state)
+{
+    const char *profile = PROFILES[state.range(0)];
+    const int batch = static_cast<int>(state.range(1));
+    std::string path = databasePath(std::string("update-") + profile);
+    removeDatabase(path);
+
+    std::mt19937 rng(42);
+    {
+        auto database = openDatabase(path, profile);
+        database->beginTransaction();
+        for (int id = 1; id <= STARTUP_ORDERS; ++id)
+            database->orders()->insert(makeOrder(id, rng));
+        database->commitTransaction();
+
+        for (auto _ : state)
+        {
+            database->beginTransaction();
+            for (int i = 0; i < batch; ++i)
+            {
+                auto order = makeOrder(1 + rng() % STARTUP_ORDERS, rng);
+                order.setRemainingQuantity(5);
+                order.setStatus(OrderStatus::PARTIALLY_FILLED);
+                database->orders()->update(order);
+            }
+            database->commitTransaction();
+        }
+    }
+
+    removeDatabase(path);
+    state.SetItemsProcessed(state.iterations() * batch);
+    state.SetLabel(profile);
+}
+BENCHMARK(BM_StorageUpdate)->ArgsProduct({{0, 1, 2, 3}, {1, 1000}});
+
+// Opens a 100k-order database, a tenth of it still resting, and loads the book the way the services do
+// at startup.
+static void BM_StorageStartupLoad(benchmark::State &state)
+{
+    const char *profile = PROFILES[state.range(0)];
+    std::string path = databasePath(std::string("startup-") + profile);
+    removeDatabase(path);
+
+    std::mt19937 rng(42);
+    {
+        auto database = openDatabase(path, profile);
+        database->beginTransaction();
+        for (int id = 1; id <= STARTUP_ORDERS; ++id)
+        {
+            auto order = makeOrder(id, rng);
+            if (id % 10 != 0)
+                order.setStatus(OrderStatus::FILLED);
+            database->orders()->insert(order);
+        }
+        database->commitTransaction();
+    }
+
+    size_t loaded = 0;
+    for (auto _ : state)
+    {
+        auto database = openDatabase(path, profile);
+        auto active = database->orders()->getAllActive();
+        database->orders()->forEachActiveConditional([](std::shared_ptr<Order>) {});
+        loaded = active.size();
+        benchmark::DoNotOptimize(active);
+    }
+
+    removeDatabase(path);
+    state.counters["orders"] = static_cast<double>(loaded);
+    state.SetLabel(profile);
+}
+BENCHMARK(BM_StorageStartupLoad)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#include "TrailingStopIndex.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int TRAILING_STOPS = 50000;
+static const int TICKS = 1000000;
+static const int64_t START_TICKS = 10000;
+static const int MAX_OFFSET_TICKS = 200;
+
+// 50k trailing sells and buys ride a one-tick random walk for 1M ticks. Triggered stops are replaced at the
+// current price so the population stays constant for the whole walk.
+static void BM_TrailingStopRandomWalk(benchmark::State &state)
+{
+    const std::string trader = "Trailer";
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> offsets(1, MAX_OFFSET_TICKS);
+    std::bernoulli_distribution upTick(0.5);
+
+    TrailingStopIndex buys(OrderSide::BID);
+    TrailingStopIndex sells(OrderSide::ASK);
+    std::vector<std::shared_ptr<Order>> triggered;
+    Price price = Price::fromTicks(START_TICKS);
+    int nextId = 1;
+
+    auto place = [&](OrderSide side)
+    {
+        auto order = std::make_shared<Order>(OrderType::TRAILING_STOP, side, 10, trader, Price::fromTicks(offsets(rng)), -1, -1, Price(), price);
+        order->setId(nextId++);
+        (side == OrderSide::BID ? buys : sells).addOrder(order);
+    };
+
+    for (int i = 0; i < TRAILING_STOPS; ++i)
+        place(i % 2 == 0 ? OrderSide::BID : OrderSide::ASK);
+
+    int64_t triggeredCount = 0;
+    for (auto _ : state)
+    {
+        for (int tick = 0; tick < TICKS; ++tick)
+        {
+            price = Price::fromTicks(price.getTicks() + (upTick(rng) ? 1 : -1));
+
+            triggered.clear();
+            buys.triggerOrders(price, triggered);
+            sells.triggerOrders(price, triggered);
+
+            triggeredCount += static_cast<int64_t>(triggered.size());
+            for (const auto &order : triggered)
+                place(order->getSide());
+        }
+    }
+
+    state.counters["triggered"] = benchmark::Counter(static_cast<double>(triggeredCount));
+    state.SetItemsProcessed(state.iterations() * TICKS);
+}
+BENCHMARK(BM_TrailingStopRandomWalk)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+BENCHMARK_MAIN();
@@ -11,11 +11,13 @@ void handleWebsocketOpen(Server &server, crow::websocket::connection &connection
 void handleWebsocketClose(Server &server, crow::websocket::connection &connection);
 
 crow::response handlePostOrders(Server &server, const crow::request &req);
+crow::response handlePostOrdersBatch(Server &server, const crow::request &req);
 crow::response handleGetOrders(Server &server, const crow::request &req);
 crow::response handleDeleteOrder(Server &server, int orderId);
 crow::response handleGetTrades(Server &server, const crow::request &req);
 crow::response handleGetTraderById(Server &server, const std::string &traderId);
 crow::response handleGetMarket(Server &server);
+crow::response handleGetDepth(Server &server, const crow::request &req);
 crow::response handlePutRisk(Server &server, const crow::request &req);
 crow::response handleGetRisk(Server &server, const crow::request &req);
 
@@ -38,7 +38,7 @@ struct CORSHandler
 class Server
 {
 public:
-    Server(const std::string &dbFilePath);
+    Server(const std::string &dbFilePath, StorageOptions storageOptions = {}, PersistenceOptions persistenceOptions = {});
     ~Server();
     void start();
 
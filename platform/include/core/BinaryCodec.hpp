@@ -0,0 +1,76 @@
+#ifndef BINARY_CODEC_HPP
+#define BINARY_CODEC_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Native-endian field encoding for the journal, checkpoints and snapshots. Files are only read back by
+// the same build that wrote them, so there is no attempt at portability.
+class Encoder
+{
+public:
+    template <typename T>
+    Encoder &put(T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        return *this;
+    }
+
+    Encoder &putString(std::string_view value)
+    {
+        put(static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+        return *this;
+    }
+
+    std::string take() { return std::move(buffer); }
+
+private:
+    std::string buffer;
+};
+
+class Decoder
+{
+public:
+    explicit Decoder(std::string_view payload) : payload(payload) {}
+
+    template <typename T>
+    T get()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string_view getString() { return take(get<uint32_t>()); }
+
+    bool done() const { return payload.empty(); }
+
+private:
+    std::string_view payload;
+
+    std::string_view take(size_t size)
+    {
+        if (size > payload.size())
+            throw std::runtime_error("Truncated record");
+        auto bytes = payload.substr(0, size);
+        payload.remove_prefix(size);
+        return bytes;
+    }
+};
+
+// Replaces `path` with `contents` through a synced temporary file and a rename, so a crash leaves either
+// the old file or the new one.
+void writeFileAtomically(const std::string &path, std::string_view contents);
+
+// The whole file, or nothing if it does not exist.
+std::optional<std::string> readFile(const std::string &path);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef ID_SEQUENCER_HPP
+#define ID_SEQUENCER_HPP
+
+#include <atomic>
+
+// Hands out increasing ids in memory, so a new order or trade is numbered without a round trip to the
+// database. Seeded with the highest id already stored, so ids carry on across restarts.
+class IdSequencer
+{
+public:
+    explicit IdSequencer(int lastId = 0) : lastId(lastId) {}
+
+    int next() { return lastId.fetch_add(1, std::memory_order_relaxed) + 1; }
+    int last() const { return lastId.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> lastId;
+};
+
+#endif
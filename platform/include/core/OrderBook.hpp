@@ -8,11 +8,18 @@
 #include "services/TraderService.hpp"
 #include "services/MarketService.hpp"
 #include "database/Database.hpp"
+#include "database/PersistenceWriter.hpp"
 #include "events/EventLogger.hpp"
+#include "IdSequencer.hpp"
+#include "Snapshot.hpp"
 
+#include <deque>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <string>
 
 struct OrdersData
 {
@@ -30,13 +37,34 @@ struct TradesData
 
 struct MarketData
 {
-    double marketPrice;
+    Price marketPrice;
     double volatility;
     OrdersData bids;
     OrdersData asks;
     TradesData trades;
 };
 
+// Outcome of one order in a batch: the order as it stands after matching, or the reason it was refused.
+struct BatchOrderResult
+{
+    std::optional<Order> order;
+    std::string error;
+
+    bool accepted() const { return order.has_value(); }
+};
+
+// Stop cascades run by addOrder and updateMarketPrice. Depth counts generations of triggers (a stop fired by
+// a fill of a triggered stop is depth 2); size counts triggered orders entered in one call.
+struct CascadeStats
+{
+    uint64_t cascades = 0;
+    size_t lastDepth = 0;
+    size_t maxDepth = 0;
+    size_t lastSize = 0;
+    size_t maxSize = 0;
+    uint64_t deferred = 0;
+};
+
 class OrderBook
 {
 public:
@@ -45,20 +73,48 @@ public:
         std::shared_ptr<EventLogger> eventLogger,
         std::shared_ptr<MarketService> marketService,
         std::shared_ptr<RiskService> riskService,
-        std::shared_ptr<TraderService> traderService);
+        std::shared_ptr<TraderService> traderService,
+        PersistenceOptions persistenceOptions = {});
     ~OrderBook() = default;
 
     Order addOrder(Order &order);
+    std::vector<BatchOrderResult> addOrders(std::span<Order> orders);
     bool cancelOrder(int orderId);
     bool modifyOrder(int orderId, double newPrice, int newQuantity);
 
     void updateMarketPrice(double currentMarketPrice, double volatility);
+    void saveTrailingStops();
+
+    // Writes market state to `path`, stores every trader's latest state and checkpoints storage, so a
+    // restart only replays what happened after this call.
+    void saveSnapshot(const std::string &path);
+    // Restores the market state at `path`, if there is a snapshot, and moves it on through the trades
+    // recorded after it.
+    bool loadSnapshot(const std::string &path);
+    PersistenceStats getPersistenceStats() const { return persistence->getStats(); }
+    void setSelfTradePrevention(SelfTradePrevention mode)
+    {
+        std::lock_guard lock(mutex);
+        activeOrderService->setSelfTradePrevention(mode);
+    }
+    void setCascadeLimit(size_t limit)
+    {
+        std::lock_guard lock(mutex);
+        cascadeLimit = limit;
+    }
+    CascadeStats getCascadeStats() const
+    {
+        std::lock_guard lock(mutex);
+        return cascadeStats;
+    }
 
     std::vector<Order> getActiveAsks(int start = 0, int limit = -1) const;
     std::vector<Order> getActiveBids(int start = 0, int limit = -1) const;
     std::vector<Order> getConditionalAsks(int start = 0, int limit = -1) const;
     std::vector<Order> getConditionalBids(int start = 0, int limit = -1) const;
     std::vector<Trade> getTrades(int start, int limit) const;
+    std::vector<Trade> getTradesBefore(int beforeId, int limit) const;
+    std::vector<DepthLevel> getDepth(OrderSide side, int levels = -1) const;
 
     OrderCounts countOrdersForTrader(const std::string &traderId) const;
 
@@ -68,16 +124,47 @@ public:
 
     EventLogger &getEventLogger() const { return *eventLogger; }
 
+    // Held by every public member while it reads or changes the book, so request threads and the periodic
+    // checkpoints in main never run against each other. Callers reading the traders or risk limits the book
+    // uses, outside of its members, take it too.
+    std::recursive_mutex &getMutex() const { return mutex; }
+
 private:
     std::shared_ptr<Database> database;
     std::shared_ptr<EventLogger> eventLogger;
     std::shared_ptr<MarketService> marketService;
     std::shared_ptr<RiskService> riskService;
     std::shared_ptr<TraderService> traderService;
+    std::shared_ptr<PersistenceWriter> persistence;
     std::shared_ptr<TradeService> tradeService;
+    IdSequencer orderIds;
 
     std::unique_ptr<ActiveOrderService> activeOrderService;
     std::unique_ptr<ConditionalOrderService> conditionalOrderService;
+    mutable std::recursive_mutex mutex;
+
+    struct TriggeredOrder
+    {
+        std::shared_ptr<Order> order;
+        size_t depth;
+    };
+
+    // Triggered orders waiting to be entered. Anything beyond the cascade limit is restored to the
+    // conditional book, where it stays visible and cancellable until the next price check triggers it again.
+    std::deque<TriggeredOrder> triggerQueue;
+    std::vector<std::shared_ptr<Order>> triggeredOrders;
+    size_t cascadeDepth = 0;
+    size_t cascadeLimit = DEFAULT_CASCADE_LIMIT;
+    CascadeStats cascadeStats;
+
+    static constexpr size_t DEFAULT_CASCADE_LIMIT = 1000;
+
+    // Enters the order and runs the cascade it sets off, without waiting for persistence.
+    void processOrder(Order &order);
+    void enterOrder(Order &order);
+    bool cancelLocked(int orderId);
+    void queueTriggeredOrders(Price currentMarketPrice, size_t depth);
+    void runCascade();
 };
 
 #endif
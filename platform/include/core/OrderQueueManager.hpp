@@ -2,55 +2,199 @@
 #define ORDER_QUEUE_MANAGER_HPP
 
 #include "models/Order.hpp"
+#include "SlabPool.hpp"
 
-#include <queue>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory_resource>
 #include <unordered_map>
-#include <memory>
 #include <vector>
 
-struct OrderComparator
+struct PriceComparator
 {
-    bool operator()(const std::shared_ptr<Order> &lhs,
-                    const std::shared_ptr<Order> &rhs) const
+    OrderSide side;
+
+    bool operator()(Price lhs, Price rhs) const
     {
-        if (lhs->getSide() != rhs->getSide())
-            throw std::runtime_error("Comparing orders with different sides");
-        if (lhs->getSide() == OrderSide::ASK)
-        {
-            if (lhs->getPrice() == rhs->getPrice())
-                return lhs->getId() > rhs->getId();
-            return lhs->getPrice() > rhs->getPrice();
-        }
-        if (lhs->getPrice() == rhs->getPrice())
-            return lhs->getId() > rhs->getId();
-        return lhs->getPrice() < rhs->getPrice();
+        if (side == OrderSide::ASK)
+            return lhs < rhs;
+        return lhs > rhs;
     }
 };
 
-using OrderQueue = std::priority_queue<std::shared_ptr<Order>,
-                                       std::vector<std::shared_ptr<Order>>,
-                                       OrderComparator>;
+struct OrderEntry;
+
+using OrderHandle = SlabHandle;
+
+// Intrusive FIFO threaded through the order map entries, so linking and unlinking never allocates.
+class OrderList
+{
+public:
+    class iterator
+    {
+    public:
+        explicit iterator(const OrderEntry *node) : node(node) {}
+
+        const Order &operator*() const;
+        const Order *operator->() const;
+        iterator &operator++();
+        bool operator!=(const iterator &other) const { return node != other.node; }
+
+    private:
+        const OrderEntry *node;
+    };
+
+    iterator begin() const { return iterator(head); }
+    iterator end() const { return iterator(nullptr); }
+    bool empty() const { return head == nullptr; }
+
+    void insert(OrderEntry *position, OrderEntry *entry);
+    void erase(OrderEntry *entry);
+    OrderEntry *first() const { return head; }
+    OrderEntry *last() const { return tail; }
+
+private:
+    OrderEntry *head = nullptr;
+    OrderEntry *tail = nullptr;
+};
+
+struct PriceLevel
+{
+    OrderList orders;
+    int totalQuantity = 0;
+    int orderCount = 0;
+};
+
+struct SideTotals
+{
+    int orderCount = 0;
+    long long quantity = 0;
+};
+
+struct DepthLevel
+{
+    Price price;
+    int quantity;
+    int orderCount;
+};
+
+// Levels are keyed by price and sorted best-first, so begin() is always the top of the book.
+using PriceLevels = std::pmr::map<Price, PriceLevel, PriceComparator>;
 
+// Pool slot for a live order: the order itself plus its position in the book.
+struct OrderEntry
+{
+    explicit OrderEntry(const Order &order) : order(order) {}
+
+    Order order;
+    OrderHandle handle;
+    bool queued = false;
+    int queuedQuantity = 0;
+    PriceLevels::iterator level;
+    OrderEntry *prev = nullptr;
+    OrderEntry *next = nullptr;
+};
+
+// Read-only view of one side of the book in price-time order; walks the levels in place rather than copying them.
+class OrderRange
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Order;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Order *;
+        using reference = const Order &;
+
+        iterator() = default;
+        iterator(PriceLevels::const_iterator level, PriceLevels::const_iterator levelsEnd,
+                 const OrderEntry *node, int remaining);
+
+        const Order &operator*() const { return node->order; }
+        const Order *operator->() const { return &node->order; }
+        iterator &operator++();
+        bool operator!=(const iterator &other) const { return node != other.node; }
+        bool operator==(const iterator &other) const { return node == other.node; }
+
+    private:
+        PriceLevels::const_iterator level;
+        PriceLevels::const_iterator levelsEnd;
+        const OrderEntry *node = nullptr;
+        int remaining = -1;
+    };
+
+    OrderRange(const PriceLevels &levels, int start, int limit);
+
+    iterator begin() const { return first; }
+    iterator end() const { return iterator(); }
+    bool empty() const { return first == end(); }
+
+private:
+    iterator first;
+};
+
+inline const Order &OrderList::iterator::operator*() const { return node->order; }
+inline const Order *OrderList::iterator::operator->() const { return &node->order; }
+
+inline OrderList::iterator &OrderList::iterator::operator++()
+{
+    node = node->next;
+    return *this;
+}
+
+using OrderMap = std::pmr::unordered_map<int, OrderHandle>;
+
+// Owns every live order. Orders are stored in a slab pool and referred to by handle, and the map and level
+// nodes come from a pooled resource, so adding and removing orders at steady state does not touch the heap.
 class OrderQueueManager
 {
 public:
     OrderQueueManager() = default;
 
-    void addOrder(const std::shared_ptr<Order> &order);
-    void storeOrder(const std::shared_ptr<Order> &order);
-    void enqueueOrder(const std::shared_ptr<Order> &order);
-    void removeOrder(int orderId, OrderSide side);
-    OrderQueue &getQueue(OrderSide side);
-    std::shared_ptr<Order> getOrder(int orderId) const;
-    std::vector<std::shared_ptr<Order>> getOrders(OrderSide side, int start, int limit) const;
-    std::shared_ptr<Order> getBestOrder(OrderSide side) const;
-    const std::unordered_map<int, std::shared_ptr<Order>> &getOrderMap() const;
-    void updateOrderInBook(const std::shared_ptr<Order> &order);
+    OrderHandle addOrder(const Order &order);
+    OrderHandle storeOrder(const Order &order);
+    void enqueueOrder(OrderHandle handle);
+    void dequeueOrder(OrderHandle handle);
+    void removeOrder(int orderId);
+    void releaseOrder(OrderHandle handle);
+    void updateQuantity(OrderHandle handle, int remainingQuantity);
+    const PriceLevels &getLevels(OrderSide side) const;
+    OrderHandle getFrontOrder(OrderSide side) const;
+    OrderHandle getNextOrder(OrderHandle handle) const;
+    OrderHandle findOrder(int orderId) const;
+    Order *getOrder(OrderHandle handle);
+    const Order *getOrder(OrderHandle handle) const;
+    Order &getOrder(int orderId);
+    OrderRange getOrders(OrderSide side, int start, int limit) const;
+    std::vector<DepthLevel> getDepth(OrderSide side, int levels) const;
+    const SideTotals &getTotals(OrderSide side) const;
+    int getQueuedOrderCount(uint32_t traderIndex, OrderSide side) const;
+    const Order &getBestOrder(OrderSide side) const;
+    const OrderMap &getOrderMap() const;
+    void updateOrderInBook(OrderHandle handle);
 
 private:
-    OrderQueue bidQueue;
-    OrderQueue askQueue;
-    std::unordered_map<int, std::shared_ptr<Order>> orderMap;
+    std::pmr::unsynchronized_pool_resource nodeResource;
+    SlabPool<OrderEntry> entries;
+
+    PriceLevels bidLevels{PriceComparator{OrderSide::BID}, &nodeResource};
+    PriceLevels askLevels{PriceComparator{OrderSide::ASK}, &nodeResource};
+    SideTotals bidTotals;
+    SideTotals askTotals;
+
+    // Resting orders per side for each trader index, so callers can tell when a trader has no liquidity of
+    // their own in the way and the per-level totals can be used as they are.
+    std::vector<OrderCounts> queuedByTrader;
+
+    OrderMap orderMap{&nodeResource};
+
+    OrderEntry &entryAt(OrderHandle handle);
+    PriceLevels &levelsFor(OrderSide side);
+    SideTotals &totalsFor(OrderSide side);
+    void countQueued(const Order &order, int change);
 };
 
 #endif
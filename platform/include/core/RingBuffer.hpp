@@ -0,0 +1,47 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Fixed-capacity buffer that keeps the most recent `capacity` values. Storage is reserved once up front;
+// pushing onto a full buffer overwrites the oldest value in place. Index 0 is the oldest value held.
+template <typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(size_t capacity) : limit(capacity)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("Ring buffer capacity must be positive");
+        slots.reserve(capacity);
+    }
+
+    void push(T value)
+    {
+        if (slots.size() < limit)
+        {
+            slots.push_back(std::move(value));
+            return;
+        }
+        slots[head] = std::move(value);
+        head = (head + 1) % limit;
+    }
+
+    const T &operator[](size_t index) const { return slots[(head + index) % limit]; }
+    const T &front() const { return (*this)[0]; }
+    const T &back() const { return (*this)[slots.size() - 1]; }
+
+    size_t size() const { return slots.size(); }
+    size_t capacity() const { return limit; }
+    bool empty() const { return slots.empty(); }
+
+private:
+    std::vector<T> slots;
+    size_t limit;
+    size_t head = 0;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef SLAB_POOL_HPP
+#define SLAB_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Index into a SlabPool. The generation changes each time a slot is released, so a handle to an object
+// that has since been released resolves to nullptr rather than to whatever reused the slot.
+struct SlabHandle
+{
+    static constexpr uint32_t NO_INDEX = UINT32_MAX;
+
+    uint32_t index = NO_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != NO_INDEX; }
+    bool operator==(const SlabHandle &) const = default;
+};
+
+// Fixed-size chunks of slots threaded onto a free list. Objects never move once constructed, and released
+// slots are reused before any new chunk is allocated, so a pool at steady state does no heap allocation.
+template <typename T>
+class SlabPool
+{
+public:
+    SlabPool() = default;
+    SlabPool(const SlabPool &) = delete;
+    SlabPool &operator=(const SlabPool &) = delete;
+
+    ~SlabPool()
+    {
+        for (uint32_t index = 0; index < slotCount; ++index)
+        {
+            Slot &slot = slotAt(index);
+            if (slot.live)
+                std::destroy_at(&slot.value);
+        }
+    }
+
+    template <typename... Args>
+    SlabHandle allocate(Args &&...args)
+    {
+        if (freeHead == NO_SLOT)
+            grow();
+
+        uint32_t index = freeHead;
+        Slot &slot = slotAt(index);
+        std::construct_at(&slot.value, std::forward<Args>(args)...);
+        freeHead = slot.nextFree;
+        slot.live = true;
+        ++liveCount;
+        return SlabHandle{index, slot.generation};
+    }
+
+    void release(SlabHandle handle)
+    {
+        if (!get(handle))
+            return;
+
+        Slot &slot = slotAt(handle.index);
+        std::destroy_at(&slot.value);
+        slot.live = false;
+        ++slot.generation;
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+        --liveCount;
+    }
+
+    const T *get(SlabHandle handle) const
+    {
+        if (handle.index >= slotCount)
+            return nullptr;
+        const Slot &slot = slotAt(handle.index);
+        return (slot.live && slot.generation == handle.generation) ? &slot.value : nullptr;
+    }
+
+    T *get(SlabHandle handle) { return const_cast<T *>(std::as_const(*this).get(handle)); }
+
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return slotCount; }
+
+private:
+    static constexpr uint32_t CHUNK_SIZE = 1024;
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    struct Slot
+    {
+        Slot() {}
+        ~Slot() {}
+
+        union
+        {
+            T value;
+        };
+        uint32_t generation = 0;
+        uint32_t nextFree = NO_SLOT;
+        bool live = false;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    uint32_t slotCount = 0;
+    uint32_t freeHead = NO_SLOT;
+    size_t liveCount = 0;
+
+    Slot &slotAt(uint32_t index) { return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+    const Slot &slotAt(uint32_t index) const { return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+    void grow()
+    {
+        chunks.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+        Slot *chunk = chunks.back().get();
+        for (uint32_t offset = CHUNK_SIZE; offset-- > 0;)
+        {
+            chunk[offset].nextFree = freeHead;
+            freeHead = slotCount + offset;
+        }
+        slotCount += CHUNK_SIZE;
+    }
+};
+
+#endif
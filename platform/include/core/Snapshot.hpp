@@ -0,0 +1,21 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "services/MarketService.hpp"
+
+#include <optional>
+#include <string>
+
+// Engine state that storage does not hold: the market. Orders, trades and trader positions live in storage,
+// so restoring a snapshot only has to replay the prices of the trades recorded after `lastTradeId`.
+struct BookSnapshot
+{
+    int lastTradeId = 0;
+    MarketState market;
+
+    void save(const std::string &path) const;
+    // Nothing if there is no snapshot at `path`.
+    static std::optional<BookSnapshot> load(const std::string &path);
+};
+
+#endif
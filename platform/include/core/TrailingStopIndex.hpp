@@ -0,0 +1,69 @@
+#ifndef TRAILING_STOP_INDEX_HPP
+#define TRAILING_STOP_INDEX_HPP
+
+#include "models/Order.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Trailing stops for one side, grouped by water mark: the best price seen since placement, which is the
+// same for every order placed at or below the current high (or at or above the current low for buys). A
+// tick that sets a new extreme merges every group it passes into one, so best prices are never updated
+// order by order. Within a group, orders are keyed by trail offset, and a tick only visits the groups whose
+// nearest trigger it crosses.
+//
+// Prices are held in side-normalized ticks (negated for buys), so both sides trail a running maximum and
+// trigger once the market falls to the water mark less the offset.
+class TrailingStopIndex
+{
+public:
+    explicit TrailingStopIndex(OrderSide side) : side(side) {}
+
+    void addOrder(const std::shared_ptr<Order> &order);
+    std::shared_ptr<Order> findOrder(int orderId) const;
+    std::shared_ptr<Order> removeOrder(int orderId);
+
+    // Moves the water marks to `currentMarketPrice` and appends the orders it triggers, removing them.
+    void triggerOrders(Price currentMarketPrice, std::vector<std::shared_ptr<Order>> &triggeredOrders);
+
+    // Visits orders with their best price brought up to date, until `visit` returns false.
+    void forEachOrder(const std::function<bool(const std::shared_ptr<Order> &)> &visit) const;
+
+    size_t size() const { return locations.size(); }
+
+private:
+    using Members = std::multimap<int64_t, std::shared_ptr<Order>>;
+
+    struct Group
+    {
+        int64_t waterMark = 0;
+        Members members;
+    };
+
+    struct Location
+    {
+        Group *group;
+        Members::iterator member;
+    };
+
+    OrderSide side;
+    std::map<int64_t, Group> groups;
+    std::set<std::pair<int64_t, int64_t>, std::greater<>> triggers;
+    std::unordered_map<int, Location> locations;
+
+    int64_t normalize(Price price) const { return (side == OrderSide::ASK) ? price.getTicks() : -price.getTicks(); }
+    Price denormalize(int64_t ticks) const { return Price::fromTicks((side == OrderSide::ASK) ? ticks : -ticks); }
+
+    void raiseWaterMark(int64_t waterMark);
+    void indexTrigger(const Group &group);
+    void unindexTrigger(const Group &group);
+    void syncBestPrice(const Group &group, Order &order) const;
+};
+
+#endif
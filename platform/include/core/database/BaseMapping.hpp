@@ -19,8 +19,29 @@ template <typename T>
 class BaseMapping
 {
 public:
-    static std::string generateInsertSQL(const std::string &tableName,
-                                         const std::vector<FieldDescriptor<T>> &fields)
+    // Insert with a caller-assigned id, bound after the fields as in generateUpdateSQL.
+    static std::string generateInsertWithIdSQL(const std::string &tableName,
+                                               const std::vector<FieldDescriptor<T>> &fields)
+    {
+        std::stringstream ss;
+        ss << "INSERT INTO " << tableName << " (";
+        for (const auto &field : fields)
+        {
+            ss << field.columnName << ", ";
+        }
+        ss << "id) VALUES (";
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            ss << "?, ";
+        }
+        ss << "?);";
+        return ss.str();
+    }
+
+    // Insert, or overwrite every field of the row already holding the same `keyColumn` value.
+    static std::string generateUpsertSQL(const std::string &tableName,
+                                         const std::vector<FieldDescriptor<T>> &fields,
+                                         const std::string &keyColumn)
     {
         std::stringstream ss;
         ss << "INSERT INTO " << tableName << " (";
@@ -33,15 +54,22 @@ public:
             first = false;
         }
         ss << ") VALUES (";
-        first = true;
         for (size_t i = 0; i < fields.size(); i++)
         {
+            ss << (i == 0 ? "?" : ", ?");
+        }
+        ss << ") ON CONFLICT(" << keyColumn << ") DO UPDATE SET ";
+        first = true;
+        for (const auto &field : fields)
+        {
+            if (field.columnName == keyColumn)
+                continue;
             if (!first)
                 ss << ", ";
-            ss << "?";
+            ss << field.columnName << " = excluded." << field.columnName;
             first = false;
         }
-        ss << ") RETURNING id;";
+        ss << ";";
         return ss.str();
     }
 
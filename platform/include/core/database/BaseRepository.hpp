@@ -3,6 +3,7 @@
 
 #include "database/BaseMapping.hpp"
 #include <sqlite3.h>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -12,43 +13,66 @@ class BaseRepository
 {
 public:
     BaseRepository(sqlite3 *connection) : db(connection) {}
-    
-    int createRecord(const T &entity)
+    BaseRepository(const BaseRepository &) = delete;
+    BaseRepository &operator=(const BaseRepository &) = delete;
+
+    void insertRecord(const T &entity)
     {
-        std::string sql = BaseMapping<T>::generateInsertSQL(T::tableName, T::fields);
-        sqlite3_stmt *stmt = nullptr;
-        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
-        if (rc != SQLITE_OK)
-        {
-            throw std::runtime_error("Prepare error in create: " + std::string(sqlite3_errmsg(db)));
-        }
+        sqlite3_stmt *stmt = prepareCached(insertWithIdStmt, insertWithIdSQL(), "insert");
+        StatementReset reset{stmt};
         int index = 1;
         for (const auto &field : T::fields)
         {
             field.bindFunc(stmt, index++, entity);
         }
-        int newId = -1;
-        if (sqlite3_step(stmt) == SQLITE_ROW)
+
+        sqlite3_bind_int(stmt, index, entity.getId());
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE)
         {
-            newId = sqlite3_column_int(stmt, 0);
+            throw std::runtime_error("Insert failed: " + std::string(sqlite3_errmsg(db)));
         }
-        sqlite3_finalize(stmt);
-        if (newId == -1)
+    }
+
+    // Inserts or overwrites the record keyed by T::keyColumn; the id is left to SQLite.
+    void upsertRecord(const T &entity)
+    {
+        sqlite3_stmt *stmt = prepareCached(upsertStmt, upsertSQL(), "upsert");
+        StatementReset reset{stmt};
+        int index = 1;
+        for (const auto &field : T::fields)
         {
-            throw std::runtime_error("Failed to retrieve new id");
+            field.bindFunc(stmt, index++, entity);
+        }
+        int rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE)
+        {
+            throw std::runtime_error("Upsert failed: " + std::string(sqlite3_errmsg(db)));
         }
-        return newId;
     }
 
-    void updateRecord(const T &entity)
+    // Highest id in the table, or 0 when it is empty.
+    int getLastRecordId()
     {
-        std::string sql = BaseMapping<T>::generateUpdateSQL(T::tableName, T::fields);
+        std::string sql = "SELECT COALESCE(MAX(id), 0) FROM " + std::string(T::tableName) + ";";
         sqlite3_stmt *stmt = nullptr;
-        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
-        if (rc != SQLITE_OK)
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
         {
-            throw std::runtime_error("Prepare error in update: " + std::string(sqlite3_errmsg(db)));
+            throw std::runtime_error("Prepare error in getLastId: " + std::string(sqlite3_errmsg(db)));
         }
+        int lastId = 0;
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            lastId = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        return lastId;
+    }
+
+    void updateRecord(const T &entity)
+    {
+        sqlite3_stmt *stmt = prepareCached(updateStmt, updateSQL(), "update");
+        StatementReset reset{stmt};
         int index = 1;
         for (const auto &field : T::fields)
         {
@@ -56,16 +80,25 @@ public:
         }
 
         sqlite3_bind_int(stmt, index, entity.getId());
-        rc = sqlite3_step(stmt);
+        int rc = sqlite3_step(stmt);
         if (rc != SQLITE_DONE)
         {
-            sqlite3_finalize(stmt);
             throw std::runtime_error("Update failed: " + std::string(sqlite3_errmsg(db)));
         }
-        sqlite3_finalize(stmt);
     }
 
     std::vector<T> getAllRecords(const std::string &whereClause = "")
+    {
+        std::vector<T> results;
+        forEachRecord(whereClause, [&results](const T &entity)
+                      { results.push_back(entity); });
+        return results;
+    }
+
+    // Steps through matching rows one at a time, reusing a single entity, for loaders that consume records
+    // as they are read.
+    template <typename Visitor>
+    void forEachRecord(const std::string &whereClause, Visitor &&visit)
     {
         std::string sql = BaseMapping<T>::generateSelectSQL(
             T::tableName,
@@ -79,10 +112,9 @@ public:
         {
             throw std::runtime_error("Prepare error in getAll: " + std::string(sqlite3_errmsg(db)));
         }
-        std::vector<T> results;
+        T entity;
         while (sqlite3_step(stmt) == SQLITE_ROW)
         {
-            T entity;
             entity.setId(sqlite3_column_int(stmt, 0));
             int index = 1;
             for (const auto &field : T::fields)
@@ -93,14 +125,71 @@ public:
             {
                 joinField.extractFunc(stmt, index++, entity);
             }
-            results.push_back(entity);
+            visit(entity);
         }
         sqlite3_finalize(stmt);
-        return results;
     }
 
+protected:
+    sqlite3 *getConnection() const { return db; }
+
 private:
+    struct StatementDeleter
+    {
+        void operator()(sqlite3_stmt *stmt) const { sqlite3_finalize(stmt); }
+    };
+    using Statement = std::unique_ptr<sqlite3_stmt, StatementDeleter>;
+
+    // Returns a cached statement to its initial state once it has been used, even if the step failed.
+    struct StatementReset
+    {
+        sqlite3_stmt *stmt;
+        ~StatementReset()
+        {
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+        }
+    };
+
     sqlite3 *db;
+    Statement insertWithIdStmt;
+    Statement updateStmt;
+    Statement upsertStmt;
+
+    // The statement text only depends on the record type, so it is built once per type.
+    static const std::string &insertWithIdSQL()
+    {
+        static const std::string sql = BaseMapping<T>::generateInsertWithIdSQL(T::tableName, T::fields);
+        return sql;
+    }
+
+    static const std::string &upsertSQL()
+    {
+        static const std::string sql = BaseMapping<T>::generateUpsertSQL(T::tableName, T::fields, T::keyColumn);
+        return sql;
+    }
+
+    static const std::string &updateSQL()
+    {
+        static const std::string sql = BaseMapping<T>::generateUpdateSQL(T::tableName, T::fields);
+        return sql;
+    }
+
+    // Prepared on first use rather than in the constructor, so a repository never used for writes never
+    // touches the connection.
+    sqlite3_stmt *prepareCached(Statement &statement, const std::string &sql, const char *operation)
+    {
+        if (!statement)
+        {
+            sqlite3_stmt *stmt = nullptr;
+            if (sqlite3_prepare_v3(db, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK)
+            {
+                throw std::runtime_error("Prepare error in " + std::string(operation) + ": " + std::string(sqlite3_errmsg(db)));
+            }
+            statement.reset(stmt);
+        }
+        return statement.get();
+    }
 };
 
 #endif
\ No newline at end of file
@@ -3,36 +3,76 @@
 
 #include "database/OrderRepository.hpp"
 #include "database/TradeRepository.hpp"
+#include "database/TraderRepository.hpp"
 
-#include <sqlite3.h>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 
+enum class JournalMode : uint8_t
+{
+    ROLLBACK,
+    WAL
+};
+
+enum class SyncMode : uint8_t
+{
+    FULL,
+    NORMAL,
+    OFF
+};
+
+enum class StorageBackend : uint8_t
+{
+    SQLITE,
+    JOURNAL
+};
+
+// Connection settings applied when the database is opened. Sizes of zero leave SQLite's defaults.
+struct StorageOptions
+{
+    StorageBackend backend = StorageBackend::SQLITE;
+    JournalMode journalMode = JournalMode::ROLLBACK;
+    SyncMode synchronous = SyncMode::FULL;
+    int64_t mmapSize = 0;
+    int64_t cacheSize = 0;
+    bool indexes = false;
+
+    // Named presets: "baseline" (SQLite defaults), "wal" (WAL with synchronous=NORMAL, which can lose the
+    // last commits on power failure but never corrupts) and "fast" (WAL with synchronous=OFF). Both WAL
+    // presets also size the page cache and memory map and create the lookup indexes.
+    static StorageOptions fromProfile(const std::string &profile);
+};
+
+// Database and its repositories are the storage interface the engine writes through. Each backend
+// (SqliteDatabase, JournalDatabase, the test mocks) implements all of it.
 class Database
 {
 public:
-    Database(const std::string &dbFile);
-    virtual ~Database()
-    {
-        if (db)
-        {
-            sqlite3_close(db);
-        }
-    }
-
-    virtual std::shared_ptr<OrderRepository> orders() const
-    {
-        return ordersRepo;
-    }
-
-    virtual std::shared_ptr<TradeRepository> trades() const
-    {
-        return tradesRepo;
-    }
+    // Opens `path` with the backend named in `options`: a database file for SQLite, a directory for the
+    // journal.
+    static std::shared_ptr<Database> open(const std::string &path, StorageOptions options = {});
+
+    virtual ~Database() = default;
+
+    virtual std::shared_ptr<OrderRepository> orders() const = 0;
+    virtual std::shared_ptr<TradeRepository> trades() const = 0;
+    virtual std::shared_ptr<TraderRepository> traders() const = 0;
+
+    virtual void beginTransaction() = 0;
+    virtual void commitTransaction() = 0;
+    virtual void rollbackTransaction() = 0;
+
+    // Records the current state so the next open can start from it rather than from the beginning. A
+    // backend that keeps its stored state up to date as it goes has nothing to do.
+    virtual void checkpoint() {}
+
+    // Held by whichever thread is using the storage for a multi-statement write or a transaction.
+    std::recursive_mutex &getMutex() { return mutex; }
 
 private:
-    sqlite3 *db = nullptr;
-    std::shared_ptr<OrderRepository> ordersRepo;
-    std::shared_ptr<TradeRepository> tradesRepo;
+    std::recursive_mutex mutex;
 };
 
 #endif
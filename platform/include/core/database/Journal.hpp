@@ -0,0 +1,79 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Append-only log of length-prefixed records, split into fixed-size memory-mapped segment files
+// (journal-000001.log, journal-000002.log, ...) in one directory. Each record carries a CRC-32 of its type
+// and payload. A record that does not fit in what is left of a segment starts the next one.
+//
+// A record's position (segment and byte offset) is stable, so a checkpoint can note the end of the journal
+// and a later open can replay only what was appended after it.
+//
+// A crash can leave a torn record at the end of the newest segment; opening the journal stops at the first
+// record that fails its check there, clears the rest of the segment and appends from that point. A bad
+// record in any earlier segment is corruption and is reported as an error.
+struct JournalPosition
+{
+    size_t segment = 1;
+    // Zero means the first record of the segment.
+    size_t offset = 0;
+};
+
+class Journal
+{
+public:
+    static constexpr size_t DEFAULT_SEGMENT_SIZE = 64 << 20;
+
+    // `recoverFrom` is a position known to be intact, such as a checkpoint's; the search for the end of the
+    // journal starts there rather than at the start of the newest segment.
+    explicit Journal(const std::string &directory, size_t segmentSize = DEFAULT_SEGMENT_SIZE,
+                     JournalPosition recoverFrom = {});
+    ~Journal();
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    void append(uint8_t type, std::string_view payload);
+
+    // Writes appended records back to their segment files, blocking until the disk has them.
+    void sync();
+
+    // Visits every valid record from `from` onwards in append order, segment by segment.
+    void replay(const std::function<void(uint8_t type, std::string_view payload)> &visit,
+                JournalPosition from = {}) const;
+    // Visits every valid record in segment `index` alone.
+    void replaySegment(size_t index, const std::function<void(uint8_t type, std::string_view payload)> &visit) const;
+
+    // Where the next record will be appended.
+    JournalPosition getPosition() const { return {segment, offset}; }
+    size_t getSegmentCount() const { return segment; }
+
+private:
+    std::string directory;
+    size_t segmentSize;
+
+    // The newest segment, which appends go to.
+    size_t segment = 0;
+    int fd = -1;
+    std::byte *data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    size_t syncedOffset = 0;
+
+    std::string segmentPath(size_t index) const;
+    void openSegment(size_t index, bool create);
+    void closeSegment();
+    void replaySegment(size_t index, size_t start,
+                       const std::function<void(uint8_t type, std::string_view payload)> &visit) const;
+    // Returns the end of the last valid record; `clean` is false if a bad record was found before the
+    // zero-filled remainder.
+    size_t scanSegment(const std::byte *segmentData, size_t segmentBytes, size_t start,
+                       const std::function<void(uint8_t, std::string_view)> *visit, bool &clean) const;
+};
+
+#endif
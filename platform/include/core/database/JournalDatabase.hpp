@@ -0,0 +1,122 @@
+#ifndef JOURNAL_DATABASE_HPP
+#define JOURNAL_DATABASE_HPP
+
+#include "database/Database.hpp"
+#include "database/Journal.hpp"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Journal-backed state shared by JournalDatabase and its repositories. Every order and trader change is
+// appended as the full new state and every trade as itself; nothing is rewritten in place. Open orders,
+// trader positions, the last ids, trade totals and the most recent trades are kept in memory.
+//
+// A checkpoint writes that state to checkpoint.bin with the journal position it reflects. Opening loads
+// the checkpoint and replays only the records after it, so startup is bounded by how much was appended
+// since rather than by the length of the history.
+class JournalStore
+{
+public:
+    enum RecordType : uint8_t
+    {
+        ORDER = 1,
+        TRADE = 2,
+        // A committed transaction: the records written between begin and commit, nested in one payload so
+        // they are recovered all together or not at all.
+        BATCH = 3,
+        TRADER = 4,
+    };
+
+    JournalStore(const std::string &directory, bool syncOnCommit, size_t segmentSize);
+
+    void writeOrder(const Order &order);
+    void writeTrade(const Trade &trade);
+    void writeTrader(const TraderState &state);
+
+    void begin();
+    void commit();
+    void rollback();
+    void checkpoint();
+
+    const std::map<int, Order> &getOpenOrders() const { return openOrders; }
+    const std::map<std::string, TraderState> &getTraders() const { return traders; }
+    int getLastOrderId() const { return lastOrderId; }
+    int getLastTradeId() const { return lastTradeId; }
+    const TradeTotals &getTradeTotals() const { return tradeTotals; }
+
+    // Reads every trade back from the journal.
+    std::vector<Trade> readTrades() const;
+    // Both are served from the recent trades when they reach back far enough, otherwise read from the
+    // journal one segment at a time, newest first, stopping at the first segment that reaches back far enough.
+    std::vector<Trade> getTradePage(int beforeId, int limit) const;
+    std::vector<Trade> getTradesSince(int afterId) const;
+
+    static std::string encodeOrder(const Order &order);
+    static Order decodeOrder(std::string_view payload);
+    static std::string encodeTrade(const Trade &trade);
+    static Trade decodeTrade(std::string_view payload);
+    static std::string encodeTrader(const TraderState &state);
+    static TraderState decodeTrader(std::string_view payload);
+
+    static constexpr size_t RECENT_TRADES = 10000;
+
+private:
+    std::string checkpointPath;
+    Journal journal;
+    bool syncOnCommit;
+    bool inTransaction = false;
+    std::vector<std::pair<RecordType, std::string>> pending;
+
+    std::map<int, Order> openOrders;
+    std::map<std::string, TraderState> traders;
+    int lastOrderId = 0;
+    int lastTradeId = 0;
+    TradeTotals tradeTotals;
+    std::deque<Trade> recentTrades;
+    // Id of the first trade in each segment read so far, or 0 for a full segment with none.
+    mutable std::map<size_t, int> firstTradeIds;
+
+    static JournalPosition readCheckpointPosition(const std::string &path);
+    // Restores the checkpointed state and returns the position to replay from.
+    JournalPosition loadCheckpoint();
+    void write(RecordType type, std::string payload);
+    void apply(uint8_t type, std::string_view payload);
+    void applyOrder(const Order &order);
+    void applyTrade(const Trade &trade);
+    // Appends the trades in a record, including those nested in a batch.
+    static void collectTrades(uint8_t type, std::string_view payload, std::vector<Trade> &trades);
+    // Replaces `trades` with those in one segment, oldest first, and notes the segment's first trade id.
+    void readSegmentTrades(size_t index, std::vector<Trade> &trades) const;
+};
+
+// Alternative to the SQLite backend for write-heavy use: appends to a Journal in `directory` instead of
+// updating rows. Takes the synchronous mode from StorageOptions; anything other than OFF syncs the journal
+// to disk on every commit.
+class JournalDatabase : public Database
+{
+public:
+    JournalDatabase(const std::string &directory, StorageOptions options = {},
+                    size_t segmentSize = Journal::DEFAULT_SEGMENT_SIZE);
+
+    std::shared_ptr<OrderRepository> orders() const override { return ordersRepo; }
+    std::shared_ptr<TradeRepository> trades() const override { return tradesRepo; }
+    std::shared_ptr<TraderRepository> traders() const override { return tradersRepo; }
+
+    void beginTransaction() override { store->begin(); }
+    void commitTransaction() override { store->commit(); }
+    void rollbackTransaction() override { store->rollback(); }
+    void checkpoint() override { store->checkpoint(); }
+
+private:
+    std::shared_ptr<JournalStore> store;
+    std::shared_ptr<OrderRepository> ordersRepo;
+    std::shared_ptr<TradeRepository> tradesRepo;
+    std::shared_ptr<TraderRepository> tradersRepo;
+};
+
+#endif
@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 
 class OrderRecord
@@ -26,9 +27,9 @@ public:
         record.setTraderId(order.getTraderId());
         record.setTimestamp(order.getTimestamp());
 
-        record.setPrice(order.getPrice());
-        record.setLimitPrice(order.getLimitPrice());
-        record.setBestPrice(order.getBestPrice());
+        record.setPrice(order.getPrice().toDouble());
+        record.setLimitPrice(order.getLimitPrice().toDouble());
+        record.setBestPrice(order.getBestPrice().toDouble());
         record.setHiddenQuantity(order.getHiddenQuantity());
         record.setDisplaySize(order.getDisplaySize());
 
@@ -1,17 +1,23 @@
 #ifndef ORDER_REPOSITORY_HPP
 #define ORDER_REPOSITORY_HPP
 
-#include "database/BaseRepository.hpp"
-#include "database/OrderMapping.hpp"
+#include "models/Order.hpp"
 
-class OrderRepository : public BaseRepository<OrderRecord>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Where orders are stored. Implemented by each storage backend.
+class OrderRepository
 {
 public:
-    OrderRepository(sqlite3 *connection) : BaseRepository<OrderRecord>(connection) {}
+    virtual ~OrderRepository() = default;
 
-    virtual int create(const Order &order);
-    virtual void update(const Order &order);
-    virtual std::vector<std::shared_ptr<Order>> getAllActive();
+    virtual void insert(const Order &order) = 0;
+    virtual int getLastId() = 0;
+    virtual void update(const Order &order) = 0;
+    virtual std::vector<std::shared_ptr<Order>> getAllActive() = 0;
+    virtual void forEachActiveConditional(const std::function<void(std::shared_ptr<Order>)> &visit) = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
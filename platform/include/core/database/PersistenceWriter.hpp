@@ -0,0 +1,157 @@
+#ifndef PERSISTENCE_WRITER_HPP
+#define PERSISTENCE_WRITER_HPP
+
+#include "BoundedQueue.hpp"
+#include "database/Database.hpp"
+#include "models/Order.hpp"
+#include "models/Trade.hpp"
+#include "models/Trader.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+enum class Durability : uint8_t
+{
+    // Requests return as soon as their changes are queued.
+    WRITE_BEHIND,
+    // Each request waits for the batch holding its changes to commit before it returns.
+    COMMIT_BEFORE_RETURN
+};
+
+struct PersistenceOptions
+{
+    std::chrono::milliseconds flushInterval{10};
+    size_t maxBatchSize = 4096;
+    size_t queueCapacity = 1 << 16;
+    Durability durability = Durability::WRITE_BEHIND;
+};
+
+struct PersistenceStats
+{
+    uint64_t records = 0;
+    uint64_t batches = 0;
+    uint64_t coalesced = 0;
+    uint64_t failedCommits = 0;
+};
+
+struct OrderInsert
+{
+    Order order;
+};
+
+struct OrderUpdate
+{
+    Order order;
+};
+
+struct TradeInsert
+{
+    Trade trade;
+};
+
+struct TraderUpdate
+{
+    TraderState state;
+};
+
+// Everything queued between a BatchBegin and its BatchEnd is committed in the same transaction.
+struct BatchBegin
+{
+};
+
+struct BatchEnd
+{
+};
+
+using PersistenceRecord = std::variant<std::monostate, OrderInsert, OrderUpdate, TradeInsert, TraderUpdate, BatchBegin, BatchEnd>;
+
+// Write-behind stage between the book and the database. The matching thread queues change records without
+// blocking on SQLite; a writer thread keeps only the latest state of each order and trader and commits in
+// batches, once per flush interval or whenever a batch fills up. Ids are assigned by the engine before
+// records are queued, so nothing waits for the database to number a row.
+class PersistenceWriter
+{
+public:
+    PersistenceWriter(std::shared_ptr<Database> database, PersistenceOptions options = {});
+    ~PersistenceWriter();
+
+    PersistenceWriter(const PersistenceWriter &) = delete;
+    PersistenceWriter &operator=(const PersistenceWriter &) = delete;
+
+    void insertOrder(const Order &order);
+    void updateOrder(const Order &order);
+    void insertTrade(const Trade &trade);
+    void updateTrader(const TraderState &state);
+
+    void beginBatch();
+    void endBatch();
+
+    // Blocks until everything queued before the call has been committed. A commit that fails is retried, so
+    // this keeps waiting while storage is failing rather than returning early.
+    void flush();
+    // End-of-request hook: flushes under COMMIT_BEFORE_RETURN, does nothing under WRITE_BEHIND.
+    void sync();
+    // Id of the newest trade known to be in storage: the last one committed, or the newest stored before the
+    // writer started. Trades are queued in id order, so every trade up to it can be read back.
+    int getStoredTradeId() const { return storedTradeId.load(std::memory_order_acquire); }
+
+    const PersistenceOptions &getOptions() const { return options; }
+    PersistenceStats getStats() const;
+
+private:
+    std::shared_ptr<Database> database;
+    PersistenceOptions options;
+    BoundedQueue<PersistenceRecord> queue;
+
+    std::atomic<uint64_t> enqueued{0};
+    std::atomic<uint64_t> committed{0};
+    std::atomic<int> flushWaiters{0};
+    std::atomic<int> storedTradeId{0};
+    std::atomic<bool> stopping{false};
+
+    std::atomic<uint64_t> recordCount{0};
+    std::atomic<uint64_t> batchCount{0};
+    std::atomic<uint64_t> coalescedCount{0};
+    std::atomic<uint64_t> failedCommitCount{0};
+
+    struct PendingOrder
+    {
+        Order order;
+        bool inserted;
+    };
+
+    // Writer-thread state.
+    std::unordered_map<int, PendingOrder> pendingOrders;
+    std::vector<Trade> pendingTrades;
+    std::unordered_map<std::string, TraderState> pendingTraders;
+    uint64_t dequeued = 0;
+    int openBatches = 0;
+    std::chrono::steady_clock::time_point retryAfter;
+
+    std::thread writer;
+
+    void enqueue(PersistenceRecord record);
+    void run();
+    enum class CommitResult
+    {
+        // Another thread holds the connection.
+        BUSY,
+        COMMITTED,
+        FAILED
+    };
+
+    // How long a failed commit waits before it is tried again.
+    static constexpr std::chrono::milliseconds RETRY_INTERVAL{100};
+
+    void apply(PersistenceRecord &record);
+    CommitResult tryCommit();
+};
+
+#endif
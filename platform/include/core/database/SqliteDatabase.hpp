@@ -0,0 +1,44 @@
+#ifndef SQLITE_DATABASE_HPP
+#define SQLITE_DATABASE_HPP
+
+#include "database/Database.hpp"
+
+#include <sqlite3.h>
+#include <memory>
+#include <string>
+
+// The SQLite backend: one table per repository in the database file `dbFile`.
+class SqliteDatabase : public Database
+{
+public:
+    SqliteDatabase(const std::string &dbFile, StorageOptions options = {});
+
+    ~SqliteDatabase() override
+    {
+        if (db)
+        {
+            // Repositories may outlive this destructor with prepared statements still open; close_v2 defers
+            // the close until they are finalized.
+            sqlite3_close_v2(db);
+        }
+    }
+
+    std::shared_ptr<OrderRepository> orders() const override { return ordersRepo; }
+    std::shared_ptr<TradeRepository> trades() const override { return tradesRepo; }
+    std::shared_ptr<TraderRepository> traders() const override { return tradersRepo; }
+
+    void beginTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+
+private:
+    sqlite3 *db = nullptr;
+    void execute(const char *sql, const std::string &action);
+    void configure(const StorageOptions &options);
+
+    std::shared_ptr<OrderRepository> ordersRepo;
+    std::shared_ptr<TradeRepository> tradesRepo;
+    std::shared_ptr<TraderRepository> tradersRepo;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SQLITE_ORDER_REPOSITORY_HPP
+#define SQLITE_ORDER_REPOSITORY_HPP
+
+#include "database/BaseRepository.hpp"
+#include "database/OrderMapping.hpp"
+#include "database/OrderRepository.hpp"
+
+class SqliteOrderRepository : public OrderRepository, private BaseRepository<OrderRecord>
+{
+public:
+    SqliteOrderRepository(sqlite3 *connection) : BaseRepository<OrderRecord>(connection) {}
+
+    void insert(const Order &order) override;
+    int getLastId() override;
+    void update(const Order &order) override;
+    std::vector<std::shared_ptr<Order>> getAllActive() override;
+    void forEachActiveConditional(const std::function<void(std::shared_ptr<Order>)> &visit) override;
+};
+
+#endif
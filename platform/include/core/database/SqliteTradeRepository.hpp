@@ -0,0 +1,21 @@
+#ifndef SQLITE_TRADE_REPOSITORY_HPP
+#define SQLITE_TRADE_REPOSITORY_HPP
+
+#include "database/BaseRepository.hpp"
+#include "database/TradeMapping.hpp"
+#include "database/TradeRepository.hpp"
+
+class SqliteTradeRepository : public TradeRepository, private BaseRepository<TradeRecord>
+{
+public:
+    SqliteTradeRepository(sqlite3 *connection) : BaseRepository<TradeRecord>(connection) {}
+
+    void insert(const Trade &trade) override;
+    int getLastId() override;
+    std::vector<Trade> getAll() override;
+    TradeTotals getTotals() override;
+    std::vector<Trade> getPage(int beforeId, int limit) override;
+    std::vector<Trade> getSince(int afterId) override;
+};
+
+#endif
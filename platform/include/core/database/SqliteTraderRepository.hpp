@@ -0,0 +1,17 @@
+#ifndef SQLITE_TRADER_REPOSITORY_HPP
+#define SQLITE_TRADER_REPOSITORY_HPP
+
+#include "database/BaseRepository.hpp"
+#include "database/TraderMapping.hpp"
+#include "database/TraderRepository.hpp"
+
+class SqliteTraderRepository : public TraderRepository, private BaseRepository<TraderRecord>
+{
+public:
+    SqliteTraderRepository(sqlite3 *connection) : BaseRepository<TraderRecord>(connection) {}
+
+    void save(const TraderState &state) override;
+    std::vector<TraderState> getAll() override;
+};
+
+#endif
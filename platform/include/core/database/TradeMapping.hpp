@@ -21,10 +21,15 @@ public:
         record.setBuyOrderId(trade.getBuyOrderId());
         record.setSellOrderId(trade.getSellOrderId());
         record.setQuantity(trade.getQuantity());
-        record.setPrice(trade.getPrice());
+        record.setPrice(trade.getPrice().toDouble());
         record.setTimestamp(trade.getTimestamp());
         record.setBuyOrderType(static_cast<int>(trade.getBuyOrderType()));
         record.setSellOrderType(static_cast<int>(trade.getSellOrderType()));
+        if (trade.hasTraders())
+        {
+            record.setBuyTraderId(trade.getBuyTraderId());
+            record.setSellTraderId(trade.getSellTraderId());
+        }
 
         return record;
     }
@@ -36,9 +41,11 @@ public:
                                              static_cast<OrderType>(buyOrderType),
                                              static_cast<OrderType>(sellOrderType),
                                              quantity,
-                                             price);
+                                             Price::fromDouble(price));
         trade->setId(id);
         trade->setTimestamp(timestamp);
+        if (!buyTraderId.empty() && !sellTraderId.empty())
+            trade->setTraders(TraderIds::intern(buyTraderId), TraderIds::intern(sellTraderId));
 
         return trade;
     }
@@ -58,6 +65,8 @@ public:
     long long getTimestamp() const { return timestamp; }
     int getBuyOrderType() const { return static_cast<int>(buyOrderType); }
     int getSellOrderType() const { return static_cast<int>(sellOrderType); }
+    const std::string &getBuyTraderId() const { return buyTraderId; }
+    const std::string &getSellTraderId() const { return sellTraderId; }
 
     void setId(int value) { id = value; }
     void setBuyOrderId(int value) { buyOrderId = value; }
@@ -67,6 +76,8 @@ public:
     void setTimestamp(long long value) { timestamp = value; }
     void setBuyOrderType(int value) { buyOrderType = static_cast<OrderType>(value); }
     void setSellOrderType(int value) { sellOrderType = static_cast<OrderType>(value); }
+    void setBuyTraderId(const std::string &value) { buyTraderId = value; }
+    void setSellTraderId(const std::string &value) { sellTraderId = value; }
 
 private:
     int id;
@@ -77,6 +88,8 @@ private:
     long long timestamp;
     OrderType buyOrderType;
     OrderType sellOrderType;
+    std::string buyTraderId;
+    std::string sellTraderId;
 };
 
 #endif
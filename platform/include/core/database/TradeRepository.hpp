@@ -1,16 +1,24 @@
 #ifndef TRADE_REPOSITORY_HPP
 #define TRADE_REPOSITORY_HPP
 
-#include "database/BaseRepository.hpp"
-#include "database/TradeMapping.hpp"
+#include "models/Trade.hpp"
 
-class TradeRepository : public BaseRepository<TradeRecord>
+#include <vector>
+
+// Where trades are stored. Implemented by each storage backend.
+class TradeRepository
 {
 public:
-    TradeRepository(sqlite3 *connection) : BaseRepository<TradeRecord>(connection) {}
+    virtual ~TradeRepository() = default;
 
-    virtual int create(const Trade &trade);
-    virtual std::vector<Trade> getAll();
+    virtual void insert(const Trade &trade) = 0;
+    virtual int getLastId() = 0;
+    virtual std::vector<Trade> getAll() = 0;
+    virtual TradeTotals getTotals() = 0;
+    // Up to `limit` trades with ids below `beforeId`, newest first.
+    virtual std::vector<Trade> getPage(int beforeId, int limit) = 0;
+    // Trades with ids above `afterId`, oldest first.
+    virtual std::vector<Trade> getSince(int afterId) = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
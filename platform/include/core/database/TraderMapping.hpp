@@ -0,0 +1,119 @@
+#ifndef TRADER_MAPPING_HPP
+#define TRADER_MAPPING_HPP
+
+#include "database/BaseMapping.hpp"
+#include "models/Trader.hpp"
+#include "BinaryCodec.hpp"
+
+#include <string>
+#include <vector>
+
+// One row per trader, keyed by traderId and overwritten with the trader's latest state. Lots are a list, so
+// they are packed into a single blob rather than given a table of their own.
+class TraderRecord
+{
+public:
+    TraderRecord() {}
+
+    static TraderRecord fromState(const TraderState &state)
+    {
+        TraderRecord record;
+
+        record.setTraderId(state.traderId);
+        record.setTraderName(state.traderName);
+        Encoder lots;
+        for (const auto &lot : state.lots)
+            lots.put(lot.quantity).put(lot.price);
+        record.setLots(lots.take());
+        record.setReservedInventory(state.reservedInventory);
+        record.setTotalClosedTrades(state.totalClosedTrades);
+        record.setAvgExitPrice(state.avgExitPrice);
+        record.setWins(state.wins);
+        record.setOpenPosition(state.openPosition);
+        record.setRealizedPnL(state.realizedPnL);
+        record.setPeakValue(state.peakValue);
+        record.setTroughValue(state.troughValue);
+        record.setMaxDrawdown(state.maxDrawdown);
+
+        return record;
+    }
+
+    TraderState toState() const
+    {
+        TraderState state;
+
+        state.traderId = traderId;
+        state.traderName = traderName;
+        Decoder decoder(lots);
+        while (!decoder.done())
+        {
+            int quantity = decoder.get<int>();
+            double price = decoder.get<double>();
+            state.lots.push_back({quantity, price});
+        }
+        state.reservedInventory = reservedInventory;
+        state.totalClosedTrades = totalClosedTrades;
+        state.avgExitPrice = avgExitPrice;
+        state.wins = wins;
+        state.openPosition = openPosition;
+        state.realizedPnL = realizedPnL;
+        state.peakValue = peakValue;
+        state.troughValue = troughValue;
+        state.maxDrawdown = maxDrawdown;
+
+        return state;
+    }
+
+    static constexpr const char *tableName = "traders";
+    static constexpr const char *keyColumn = "traderId";
+    static const std::vector<FieldDescriptor<TraderRecord>> fields;
+
+    static const std::vector<std::string> joins;
+    static const std::vector<std::string> joinSelects;
+    static const std::vector<FieldDescriptor<TraderRecord>> joinFields;
+
+    int getId() const { return id; }
+    const std::string &getTraderId() const { return traderId; }
+    const std::string &getTraderName() const { return traderName; }
+    const std::string &getLots() const { return lots; }
+    int getReservedInventory() const { return reservedInventory; }
+    int getTotalClosedTrades() const { return totalClosedTrades; }
+    double getAvgExitPrice() const { return avgExitPrice; }
+    int getWins() const { return wins; }
+    int getOpenPosition() const { return openPosition; }
+    double getRealizedPnL() const { return realizedPnL; }
+    double getPeakValue() const { return peakValue; }
+    double getTroughValue() const { return troughValue; }
+    double getMaxDrawdown() const { return maxDrawdown; }
+
+    void setId(int value) { id = value; }
+    void setTraderId(const std::string &value) { traderId = value; }
+    void setTraderName(const std::string &value) { traderName = value; }
+    void setLots(const std::string &value) { lots = value; }
+    void setReservedInventory(int value) { reservedInventory = value; }
+    void setTotalClosedTrades(int value) { totalClosedTrades = value; }
+    void setAvgExitPrice(double value) { avgExitPrice = value; }
+    void setWins(int value) { wins = value; }
+    void setOpenPosition(int value) { openPosition = value; }
+    void setRealizedPnL(double value) { realizedPnL = value; }
+    void setPeakValue(double value) { peakValue = value; }
+    void setTroughValue(double value) { troughValue = value; }
+    void setMaxDrawdown(double value) { maxDrawdown = value; }
+
+private:
+    int id = 0;
+    std::string traderId;
+    std::string traderName;
+    std::string lots;
+    int reservedInventory = 0;
+    int totalClosedTrades = 0;
+    double avgExitPrice = 0.0;
+    int wins = 0;
+    int openPosition = 0;
+    double realizedPnL = 0.0;
+    double peakValue = 0.0;
+    double troughValue = 0.0;
+    double maxDrawdown = 0.0;
+};
+
+#endif
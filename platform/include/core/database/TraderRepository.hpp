@@ -0,0 +1,19 @@
+#ifndef TRADER_REPOSITORY_HPP
+#define TRADER_REPOSITORY_HPP
+
+#include "models/Trader.hpp"
+
+#include <vector>
+
+// Where each trader's latest state is stored. Implemented by each storage backend.
+class TraderRepository
+{
+public:
+    virtual ~TraderRepository() = default;
+
+    // Replaces whatever was stored for the trader with `state`.
+    virtual void save(const TraderState &state) = 0;
+    virtual std::vector<TraderState> getAll() = 0;
+};
+
+#endif
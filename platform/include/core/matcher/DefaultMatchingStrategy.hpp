@@ -3,25 +3,38 @@
 
 #include "matcher/MatchingStrategy.hpp"
 
+#include <span>
+
 class DefaultMatchingStrategy : public MatchingStrategy
 {
 public:
     void match(Order &incomingOrder,
                OrderQueueManager &orderQueueManager,
-               std::vector<std::shared_ptr<Order>> &updatedOrders,
+               MatchBuffers &buffers,
+               SelfTradePrevention selfTradePrevention,
                TradeService &tradeService,
                EventLogger &eventLogger) const override;
 
+    // Crosses the incoming order against the book, recording fills without settling them.
+    void fill(Order &incomingOrder, OrderQueueManager &orderQueueManager, MatchBuffers &buffers,
+              SelfTradePrevention selfTradePrevention = SelfTradePrevention::SKIP) const;
+
 private:
+    void settle(std::span<const Fill> fills, TradeService &tradeService, EventLogger &eventLogger) const;
     bool isPriceAcceptable(const Order &incomingOrder, const Order &opposingOrder) const;
-    void processNormalOrderMatch(std::shared_ptr<Order> opposingOrder,
+    bool preventSelfTrade(Order &incomingOrder, int &unmatchedQuantity,
+                          OrderHandle opposingHandle, Order &opposingOrder,
+                          SelfTradePrevention selfTradePrevention,
+                          OrderQueueManager &orderQueueManager,
+                          std::vector<OrderHandle> &updatedOrders) const;
+    void processNormalOrderMatch(OrderHandle opposingHandle, Order &opposingOrder,
                                  int matchQty, int availableQty,
                                  OrderQueueManager &orderQueueManager,
-                                 std::vector<std::shared_ptr<Order>> &updatedOrders) const;
-    void processIcebergOrderMatch(std::shared_ptr<Order> opposingOrder,
+                                 std::vector<OrderHandle> &updatedOrders) const;
+    void processIcebergOrderMatch(OrderHandle opposingHandle, Order &opposingOrder,
                                   int matchQty, int availableQty,
                                   OrderQueueManager &orderQueueManager,
-                                  std::vector<std::shared_ptr<Order>> &updatedOrders) const;
+                                  std::vector<OrderHandle> &updatedOrders) const;
 };
 
 #endif
@@ -1,19 +1,21 @@
 #ifndef FOK_MATCHING_STRATEGY_HPP
 #define FOK_MATCHING_STRATEGY_HPP
 
-#include "matcher/MatchingStrategy.hpp"
+#include "matcher/DefaultMatchingStrategy.hpp"
 
-class FOKMatchingStrategy : public MatchingStrategy
+class FOKMatchingStrategy final : public DefaultMatchingStrategy
 {
 public:
     void match(Order &incomingOrder,
                OrderQueueManager &orderQueueManager,
-               std::vector<std::shared_ptr<Order>> &updatedOrders,
+               MatchBuffers &buffers,
+               SelfTradePrevention selfTradePrevention,
                TradeService &tradeService,
                EventLogger &eventLogger) const override;
 
 private:
-    bool isOrderFillable(const Order &order, OrderQueueManager &orderQueueManager) const;
+    bool isOrderFillable(const Order &order, OrderQueueManager &orderQueueManager,
+                         SelfTradePrevention selfTradePrevention) const;
 };
 
 #endif
@@ -1,14 +1,15 @@
 #ifndef IOC_MATCHING_STRATEGY_HPP
 #define IOC_MATCHING_STRATEGY_HPP
 
-#include "matcher/MatchingStrategy.hpp"
+#include "matcher/DefaultMatchingStrategy.hpp"
 
-class IOCMatchingStrategy : public MatchingStrategy
+class IOCMatchingStrategy final : public DefaultMatchingStrategy
 {
 public:
     void match(Order &incomingOrder,
                OrderQueueManager &orderQueueManager,
-               std::vector<std::shared_ptr<Order>> &updatedOrders,
+               MatchBuffers &buffers,
+               SelfTradePrevention selfTradePrevention,
                TradeService &tradeService,
                EventLogger &eventLogger) const override;
 };
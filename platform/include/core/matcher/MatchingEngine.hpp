@@ -6,8 +6,6 @@
 #include "matcher/MatchingStrategy.hpp"
 #include "models/Order.hpp"
 
-#include <memory>
-
 class MatchingEngine
 {
 public:
@@ -16,10 +14,13 @@ public:
                     OrderQueueManager &orderQueueManager,
                     TradeService &tradeService,
                     EventLogger &eventLogger,
-                    std::vector<std::shared_ptr<Order>> &updatedOrders) const;
+                    MatchBuffers &buffers) const;
+
+    SelfTradePrevention getSelfTradePrevention() const { return selfTradePrevention; }
+    void setSelfTradePrevention(SelfTradePrevention mode) { selfTradePrevention = mode; }
 
 private:
-    std::shared_ptr<MatchingStrategy> getStrategyForOrder(const Order &order) const;
+    SelfTradePrevention selfTradePrevention = SelfTradePrevention::SKIP;
 };
 
 #endif
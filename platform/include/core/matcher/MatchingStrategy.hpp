@@ -5,15 +5,41 @@
 #include "services/TradeService.hpp"
 #include "events/EventLogger.hpp"
 #include "models/Order.hpp"
+#include "models/Fill.hpp"
 
 #include <vector>
 #include <memory>
 
+// What happens when an incoming order would trade against a resting order from the same trader.
+enum class SelfTradePrevention
+{
+    SKIP,           // Leave the resting order in place and match past it.
+    CANCEL_NEWEST,  // Cancel whatever remains of the incoming order.
+    CANCEL_OLDEST,  // Cancel the resting order and keep matching.
+    DECREMENT_BOTH, // Reduce both by the smaller quantity without trading; whichever reaches zero is cancelled.
+                    // An iceberg counts its hidden quantity too.
+};
+
+// Scratch space owned by the caller and reused for every match, so once the vectors have grown the match
+// loop itself does not allocate.
+struct MatchBuffers
+{
+    std::vector<Fill> fills;
+    std::vector<OrderHandle> updatedOrders;
+
+    void clear()
+    {
+        fills.clear();
+        updatedOrders.clear();
+    }
+};
+
 class MatchingStrategy {
 public:
     virtual void match(Order &incomingOrder,
                        OrderQueueManager &orderQueueManager,
-                       std::vector<std::shared_ptr<Order>> &updatedOrders,
+                       MatchBuffers &buffers,
+                       SelfTradePrevention selfTradePrevention,
                        TradeService &tradeService,
                        EventLogger &eventLogger) const = 0;
     virtual ~MatchingStrategy() = default;
@@ -15,6 +15,7 @@ std::string generateOrderRejectedMessage(const Order &order);
 std::string generateOrderTriggeredMessage(const Order &order);
 std::string generateIOCOrderCancelledMessage(const Order &order);
 std::string generateFOKOrderRejectedMessage(const Order &order);
+std::string generateSelfTradeCancelledMessage(const Order &order);
 std::string generateTradeExecutedMessage(const Trade &trade);
 
 enum class EventType
@@ -0,0 +1,26 @@
+#ifndef FILL_HPP
+#define FILL_HPP
+
+#include "models/Order.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+// A single execution recorded by the matcher. It carries everything needed to settle the trade later,
+// so the match loop never has to build a Trade, an event or a message string.
+struct Fill
+{
+    int bidOrderId;
+    int askOrderId;
+    OrderType bidType;
+    OrderType askType;
+    uint32_t bidTraderIndex;
+    uint32_t askTraderIndex;
+    Price bidPrice;
+    Price askPrice;
+    int quantity;
+};
+
+static_assert(std::is_trivially_copyable_v<Fill>, "Fill records are copied into a reusable buffer");
+
+#endif
@@ -1,12 +1,17 @@
 #ifndef ORDER_HPP
 #define ORDER_HPP
 
+#include "models/Price.hpp"
+#include "models/TraderIds.hpp"
+
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #define NOW std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()
 
-enum class OrderType
+enum class OrderType : uint8_t
 {
     LIMIT,
     MARKET,
@@ -18,18 +23,19 @@ enum class OrderType
     TRAILING_STOP,
 };
 
-enum class OrderSide
+enum class OrderSide : uint8_t
 {
     ASK,
     BID
 };
 
-enum class OrderStatus
+enum class OrderStatus : uint8_t
 {
     UNFILLED,
     PARTIALLY_FILLED,
     FILLED,
-    CANCELLED
+    CANCELLED,
+    TRIGGERED
 };
 
 struct OrderCounts
@@ -47,22 +53,22 @@ public:
         int quantity,
         const std::string &traderId,
 
-        double price = -1,
+        Price price = Price(),
         int displaySize = -1,
         int hiddenQuantity = -1,
-        int limitPrice = -1,
-        int bestPrice = -1)
-        : type(type),
+        Price limitPrice = Price(),
+        Price bestPrice = Price())
+        : price(price),
+          remainingQuantity(type == OrderType::ICEBERG ? displaySize : quantity),
+          traderIndex(TraderIds::intern(traderId)),
           side(side),
+          type(type),
           initialQuantity(quantity),
-          remainingQuantity(type == OrderType::ICEBERG ? displaySize : quantity),
-          traderId(traderId),
-          price(price),
-          displaySize(displaySize),
+          timestamp(NOW),
           hiddenQuantity(hiddenQuantity),
+          displaySize(displaySize),
           limitPrice(limitPrice),
-          bestPrice(bestPrice),
-          timestamp(NOW)
+          bestPrice(bestPrice)
     {
     }
 
@@ -72,48 +78,53 @@ public:
     OrderStatus getStatus() const { return status; }
     int getInitialQuantity() const { return initialQuantity; }
     int getRemainingQuantity() const { return remainingQuantity; }
-    std::string getTraderId() const { return traderId; }
+    uint32_t getTraderIndex() const { return traderIndex; }
+    const std::string &getTraderId() const { return TraderIds::name(traderIndex); }
     long long getTimestamp() const { return timestamp; }
 
-    double getPrice() const { return price; }
-    double getLimitPrice() const { return limitPrice; }
-    double getBestPrice() const { return bestPrice; }
+    const Price &getPrice() const { return price; }
+    const Price &getLimitPrice() const { return limitPrice; }
+    const Price &getBestPrice() const { return bestPrice; }
     int getHiddenQuantity() const { return hiddenQuantity; }
     int getDisplaySize() const { return displaySize; }
 
     void setId(int newId) { id = newId; }
     void setStatus(OrderStatus newStatus) { status = newStatus; }
-    void setPrice(double newPrice) { price = newPrice; }
+    void setPrice(Price newPrice) { price = newPrice; }
     void setInitialQuantity(int newQuantity)
     {
         initialQuantity = newQuantity;
         remainingQuantity = newQuantity;
     }
     void setRemainingQuantity(int newQuantity) { remainingQuantity = newQuantity; }
-    void setLimitPrice(double lp) { limitPrice = lp; }
-    void setBestPrice(double bp) { bestPrice = bp; }
+    void setLimitPrice(Price lp) { limitPrice = lp; }
+    void setBestPrice(Price bp) { bestPrice = bp; }
     void setHiddenQuantity(int qty) { hiddenQuantity = qty; }
     void setDisplaySize(int size) { displaySize = size; }
     void setTimestamp(long long ts) { timestamp = ts; }
 
 private:
-    int id = -1;
-    OrderType type;
+    // Fields the matcher reads for every order it visits come first, so they share the first cache line.
+    Price price;
+    int remainingQuantity;
+    uint32_t traderIndex;
     OrderSide side;
+    OrderType type;
     OrderStatus status = OrderStatus::UNFILLED;
+
+    int id = -1;
     int initialQuantity;
-    int remainingQuantity;
-    std::string traderId;
     long long timestamp;
 
-    double price = -1;
     int hiddenQuantity = -1;
     int displaySize = -1;
 
-    double limitPrice = 0.0;
-    double bestPrice = 0.0;
+    Price limitPrice;
+    Price bestPrice;
 };
 
+static_assert(sizeof(Order) <= 64, "Order should fit in a single cache line");
+
 class MarketOrder : public Order
 {
 public:
@@ -125,49 +136,49 @@ class LimitOrder : public Order
 {
 public:
     LimitOrder(OrderSide side, int quantity, const std::string &traderId, double price)
-        : Order(OrderType::LIMIT, side, quantity, traderId, price) {}
+        : Order(OrderType::LIMIT, side, quantity, traderId, Price::fromDouble(price)) {}
 };
 
 class IOCOrder : public Order
 {
 public:
     IOCOrder(OrderSide side, int quantity, const std::string &traderId, double price)
-        : Order(OrderType::IOC, side, quantity, traderId, price) {}
+        : Order(OrderType::IOC, side, quantity, traderId, Price::fromDouble(price)) {}
 };
 
 class FOKOrder : public Order
 {
 public:
     FOKOrder(OrderSide side, int quantity, const std::string &traderId, double price)
-        : Order(OrderType::FOK, side, quantity, traderId, price) {}
+        : Order(OrderType::FOK, side, quantity, traderId, Price::fromDouble(price)) {}
 };
 
 class IcebergOrder : public Order
 {
 public:
     IcebergOrder(OrderSide side, int quantity, const std::string &traderId, double price, int displaySize, int hiddenQuantity)
-        : Order(OrderType::ICEBERG, side, quantity, traderId, price, displaySize, hiddenQuantity) {}
+        : Order(OrderType::ICEBERG, side, quantity, traderId, Price::fromDouble(price), displaySize, hiddenQuantity) {}
 };
 
 class StopOrder : public Order
 {
 public:
     StopOrder(OrderSide side, int quantity, const std::string &traderId, double price)
-        : Order(OrderType::STOP, side, quantity, traderId, price) {}
+        : Order(OrderType::STOP, side, quantity, traderId, Price::fromDouble(price)) {}
 };
 
 class StopLimitOrder : public Order
 {
 public:
     StopLimitOrder(OrderSide side, int quantity, const std::string &traderId, double price, double limitPrice)
-        : Order(OrderType::STOP_LIMIT, side, quantity, traderId, price, -1, -1, limitPrice) {}
+        : Order(OrderType::STOP_LIMIT, side, quantity, traderId, Price::fromDouble(price), -1, -1, Price::fromDouble(limitPrice)) {}
 };
 
 class TrailingStopOrder : public Order
 {
 public:
     TrailingStopOrder(OrderSide side, int quantity, const std::string &traderId, double price, double bestPrice)
-        : Order(OrderType::TRAILING_STOP, side, quantity, traderId, price, -1, -1, -1, bestPrice) {}
+        : Order(OrderType::TRAILING_STOP, side, quantity, traderId, Price::fromDouble(price), -1, -1, Price(), Price::fromDouble(bestPrice)) {}
 };
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef PRICE_HPP
+#define PRICE_HPP
+
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <stdexcept>
+
+// Fixed-point price stored as a whole number of ticks. Conversion to and from decimals only happens at the
+// edges (JSON, storage, display); everything in between compares and adds exact integers.
+class Price
+{
+public:
+    constexpr Price() = default;
+
+    static constexpr Price fromTicks(int64_t ticks) { return Price(ticks); }
+
+    static Price fromDouble(double value)
+    {
+        if (value <= 0)
+            return Price();
+        return Price(std::llround(value / tickSize));
+    }
+
+    // Whether `value` is a whole number of ticks, allowing for the error in its decimal representation.
+    static bool isOnTick(double value)
+    {
+        double valueTicks = value / tickSize;
+        return std::abs(valueTicks - std::round(valueTicks)) < 1e-6;
+    }
+
+    constexpr int64_t getTicks() const { return ticks; }
+    constexpr bool isSet() const { return ticks > 0; }
+
+    // Unset prices convert back to the -1 sentinel used by the API and database.
+    double toDouble() const { return isSet() ? ticks * tickSize : -1.0; }
+
+    static double getTickSize() { return tickSize; }
+    static void setTickSize(double size)
+    {
+        if (size <= 0)
+            throw std::invalid_argument("Tick size must be positive");
+        tickSize = size;
+    }
+
+    constexpr auto operator<=>(const Price &) const = default;
+    constexpr Price operator+(Price other) const { return Price(ticks + other.ticks); }
+    constexpr Price operator-(Price other) const { return Price(ticks - other.ticks); }
+
+private:
+    static constexpr int64_t UNSET_TICKS = -1;
+
+    explicit constexpr Price(int64_t ticks) : ticks(ticks) {}
+
+    int64_t ticks = UNSET_TICKS;
+
+    // The platform trades a single instrument, so its tick size is process-wide and set once at startup.
+    static inline double tickSize = 0.01;
+};
+
+#endif
@@ -3,6 +3,15 @@
 
 #include "models/Order.hpp"
 
+#include <limits>
+
+struct TradeTotals
+{
+    int count = 0;
+    long long volume = 0;
+    double notional = 0.0;
+};
+
 class Trade
 {
 public:
@@ -12,7 +21,7 @@ public:
         OrderType buyOrderType,
         OrderType sellOrderType,
         int quantity,
-        double price)
+        Price price)
         : buyOrderId(buyOrderId),
           sellOrderId(sellOrderId),
           buyOrderType(buyOrderType),
@@ -25,27 +34,44 @@ public:
     int getBuyOrderId() const { return buyOrderId; }
     int getSellOrderId() const { return sellOrderId; }
     int getQuantity() const { return quantity; }
-    double getPrice() const { return price; }
+    Price getPrice() const { return price; }
     long long getTimestamp() const { return timestamp; }
 
     OrderType getBuyOrderType() const { return buyOrderType; }
     OrderType getSellOrderType() const { return sellOrderType; }
 
+    bool hasTraders() const { return buyTraderIndex != NO_TRADER && sellTraderIndex != NO_TRADER; }
+    uint32_t getBuyTraderIndex() const { return buyTraderIndex; }
+    uint32_t getSellTraderIndex() const { return sellTraderIndex; }
+    const std::string &getBuyTraderId() const { return TraderIds::name(buyTraderIndex); }
+    const std::string &getSellTraderId() const { return TraderIds::name(sellTraderIndex); }
+
     void setId(int tradeId) { id = tradeId; }
     void setTimestamp(long long ts) { timestamp = ts; }
     void setBuyOrderType(OrderType type) { buyOrderType = type; }
     void setSellOrderType(OrderType type) { sellOrderType = type; }
+    void setTraders(uint32_t buyIndex, uint32_t sellIndex)
+    {
+        buyTraderIndex = buyIndex;
+        sellTraderIndex = sellIndex;
+    }
 
 private:
     int id = -1;
     int buyOrderId;
     int sellOrderId;
     int quantity;
-    double price;
+    Price price;
     long long timestamp;
 
     OrderType buyOrderType;
     OrderType sellOrderType;
+
+    static constexpr uint32_t NO_TRADER = std::numeric_limits<uint32_t>::max();
+
+    // Interned trader indexes, so a trade can be applied to positions without looking its orders up.
+    uint32_t buyTraderIndex = NO_TRADER;
+    uint32_t sellTraderIndex = NO_TRADER;
 };
 
 #endif
@@ -16,6 +16,24 @@ struct Lot
 
 std::vector<Lot> generateInitialLots();
 
+// Everything about a trader that outlives a restart. Recent order times only feed a one-minute rate check,
+// so they are left out.
+struct TraderState
+{
+    std::string traderId;
+    std::string traderName;
+    std::vector<Lot> lots;
+    int reservedInventory = 0;
+    int totalClosedTrades = 0;
+    double avgExitPrice = 0.0;
+    int wins = 0;
+    int openPosition = 0;
+    double realizedPnL = 0.0;
+    double peakValue = 0.0;
+    double troughValue = 0.0;
+    double maxDrawdown = 0.0;
+};
+
 class Trader
 {
 public:
@@ -43,6 +61,9 @@ public:
 
     virtual void updateMaxDrawdown(double currentPrice);
 
+    TraderState getState() const;
+    void restoreState(const TraderState &state);
+
 private:
     std::string traderId;
     std::string traderName = generateTraderName();
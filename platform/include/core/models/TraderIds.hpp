@@ -0,0 +1,41 @@
+#ifndef TRADER_IDS_HPP
+#define TRADER_IDS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Interns trader ID strings to dense indexes at the API boundary, so the book and matcher compare and
+// look traders up by integer. Indexes are never reused, and names stay valid for the life of the process.
+//
+// Names are appended to fixed-size chunks that never move and published by bumping a count, so looking a
+// name up by index takes no lock. Only interning a new ID takes the lock exclusively.
+class TraderIds
+{
+public:
+    static uint32_t intern(const std::string &traderId);
+    // The index of `traderId` if it has been interned. Never adds it, so unknown IDs from a query cannot
+    // grow the table.
+    static std::optional<uint32_t> find(const std::string &traderId);
+    static const std::string &name(uint32_t traderIndex);
+    static size_t size();
+
+private:
+    static constexpr uint32_t CHUNK_SIZE = 4096;
+    static constexpr uint32_t MAX_CHUNKS = 4096;
+
+    static std::shared_mutex mutex;
+    static std::unordered_map<std::string_view, uint32_t> indexes;
+    static std::vector<std::unique_ptr<std::string[]>> ownedChunks;
+    static std::array<std::atomic<std::string *>, MAX_CHUNKS> chunks;
+    static std::atomic<uint32_t> count;
+};
+
+#endif
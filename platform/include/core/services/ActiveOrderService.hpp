@@ -4,6 +4,7 @@
 #include "services/TradeService.hpp"
 #include "services/TraderService.hpp"
 #include "database/Database.hpp"
+#include "database/PersistenceWriter.hpp"
 #include "matcher/MatchingEngine.hpp"
 #include "events/EventLogger.hpp"
 #include "models/Order.hpp"
@@ -13,29 +14,36 @@
 class ActiveOrderService {
 public:
     ActiveOrderService(std::shared_ptr<Database> database,
+                       std::shared_ptr<PersistenceWriter> persistence,
                        std::shared_ptr<EventLogger> eventLogger,
                        std::shared_ptr<TradeService> tradeService,
                        std::shared_ptr<TraderService> traderService);
     ~ActiveOrderService() = default;
     
-    std::shared_ptr<Order> getOrder(int orderId) const;
-    std::shared_ptr<Order> addOrder(const Order &order);
+    Order &getOrder(int orderId);
+    Order addOrder(const Order &order);
     bool cancelOrder(int orderId);
-    bool modifyOrder(int orderId, double newPrice, int newQuantity);
+    bool modifyOrder(int orderId, Price newPrice, int newQuantity);
 
-    std::vector<std::shared_ptr<Order>> getBids(int start, int limit) const;
-    std::vector<std::shared_ptr<Order>> getAsks(int start, int limit) const;
+    OrderRange getBids(int start, int limit) const;
+    OrderRange getAsks(int start, int limit) const;
+    std::vector<DepthLevel> getDepth(OrderSide side, int levels) const;
+    const SideTotals &getTotals(OrderSide side) const;
     OrderCounts countOrdersForTrader(const std::string &traderId) const;
-    std::shared_ptr<Order> getBestBid() const;
-    std::shared_ptr<Order> getBestAsk() const;
+    const Order &getBestBid() const;
+    const Order &getBestAsk() const;
+
+    void setSelfTradePrevention(SelfTradePrevention mode) { matchingEngine.setSelfTradePrevention(mode); }
 private:
     std::shared_ptr<Database> database;
+    std::shared_ptr<PersistenceWriter> persistence;
     std::shared_ptr<EventLogger> eventLogger;
     std::shared_ptr<TradeService> tradeService;
     std::shared_ptr<TraderService> traderService;
     
     OrderQueueManager orderQueueManager;
     MatchingEngine matchingEngine;
+    MatchBuffers matchBuffers;
 };
 
 #endif
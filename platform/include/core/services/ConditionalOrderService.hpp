@@ -1,17 +1,39 @@
 #ifndef CONDITIONAL_ORDER_SERVICE_HPP
 #define CONDITIONAL_ORDER_SERVICE_HPP
 
+#include "TrailingStopIndex.hpp"
+#include "database/Database.hpp"
+#include "database/PersistenceWriter.hpp"
 #include "events/EventLogger.hpp"
 #include "models/Order.hpp"
 
-#include <vector>
+#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Orders nearest to triggering come first: buy stops ascending, sell stops descending. Either way, the
+// stops crossed by a move to price P are exactly those in front of upper_bound(P).
+struct TriggerComparator
+{
+    OrderSide side;
+
+    bool operator()(Price lhs, Price rhs) const
+    {
+        if (side == OrderSide::BID)
+            return lhs < rhs;
+        return lhs > rhs;
+    }
+};
+
+using TriggerIndex = std::multimap<Price, std::shared_ptr<Order>, TriggerComparator>;
 
 class ConditionalOrderService
 {
 public:
-    ConditionalOrderService(std::shared_ptr<EventLogger> eventLogger)
-        : eventLogger(eventLogger) {}
+    ConditionalOrderService(std::shared_ptr<Database> database,
+                            std::shared_ptr<PersistenceWriter> persistence,
+                            std::shared_ptr<EventLogger> eventLogger);
     ~ConditionalOrderService() = default;
 
     std::shared_ptr<Order> getOrder(int orderId) const;
@@ -21,13 +43,39 @@ public:
     std::vector<std::shared_ptr<Order>> getBids(int start, int limit) const;
     std::vector<std::shared_ptr<Order>> getAsks(int start, int limit) const;
 
-    std::vector<std::shared_ptr<Order>> triggerOrders(double currentMarketPrice);
+    // Appends the orders triggered at `currentMarketPrice` and removes them. Costs a few index lookups when
+    // nothing is crossed, so it can be called for every trade print.
+    void triggerOrders(Price currentMarketPrice, std::vector<std::shared_ptr<Order>> &triggeredOrders);
+    // Puts back a triggered order that was not entered, so it can still be listed, cancelled and reloaded,
+    // and is triggered again by the next price check that crosses it.
+    void restoreOrder(const std::shared_ptr<Order> &orderPtr);
 
     OrderCounts countOrdersForTrader(const std::string &traderId) const;
 
+    // Queues the current best price of every trailing stop. Water marks move on every print, so they are
+    // saved in bulk rather than as they change.
+    void saveTrailingStops();
+
 private:
+    std::shared_ptr<PersistenceWriter> persistence;
     std::shared_ptr<EventLogger> eventLogger;
-    std::vector<std::shared_ptr<Order>> orders;
+
+    // STOP and STOP_LIMIT orders by trigger price, with an ID map into the indexes for cancels.
+    TriggerIndex buyStops{TriggerComparator{OrderSide::BID}};
+    TriggerIndex sellStops{TriggerComparator{OrderSide::ASK}};
+    std::unordered_map<int, TriggerIndex::iterator> stopsById;
+
+    // Trailing stops move their trigger with the market, so they are grouped by water mark instead.
+    TrailingStopIndex trailingBuys{OrderSide::BID};
+    TrailingStopIndex trailingSells{OrderSide::ASK};
+
+    TriggerIndex &getStops(OrderSide side);
+    const TriggerIndex &getStops(OrderSide side) const;
+    void indexOrder(const std::shared_ptr<Order> &orderPtr);
+    TrailingStopIndex &getTrailingStops(OrderSide side);
+    const TrailingStopIndex &getTrailingStops(OrderSide side) const;
+    std::vector<std::shared_ptr<Order>> getOrders(OrderSide side, int start, int limit) const;
+    void triggerStops(TriggerIndex &stops, Price currentMarketPrice, std::vector<std::shared_ptr<Order>> &triggeredOrders);
 };
 
 #endif
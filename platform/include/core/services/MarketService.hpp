@@ -2,8 +2,17 @@
 #define MARKET_SERVICE_HPP
 
 #include "services/TraderService.hpp"
+#include "models/Price.hpp"
 
 #include <deque>
+#include <vector>
+
+struct MarketState
+{
+    Price currentPrice;
+    double volatility = 0.0;
+    std::vector<double> priceHistory;
+};
 
 class OrderBook;
 
@@ -13,15 +22,18 @@ public:
     MarketService(std::shared_ptr<TraderService> traderService): traderService(traderService) {}
     ~MarketService() = default;
 
-    double getCurrentPrice() const { return currentPrice; }
+    Price getCurrentPrice() const { return currentPrice; }
     double getVolatility() const { return volatility; }
 
-    void updatePrice(double newPrice);
+    void updatePrice(Price newPrice);
+
+    MarketState getState() const;
+    void restoreState(const MarketState &state);
 
 private:
     std::shared_ptr<TraderService> traderService;
 
-    double currentPrice = 100.0;
+    Price currentPrice = Price::fromDouble(100.0);
     double volatility = 0.0;
     std::deque<double> priceHistory;
     static constexpr size_t MAX_HISTORY_SIZE = 50;
@@ -4,9 +4,14 @@
 #include "services/MarketService.hpp"
 #include "services/TraderService.hpp"
 #include "database/Database.hpp"
+#include "database/PersistenceWriter.hpp"
 #include "events/EventLogger.hpp"
 #include "models/Trade.hpp"
+#include "models/Fill.hpp"
+#include "IdSequencer.hpp"
+#include "RingBuffer.hpp"
 
+#include <functional>
 #include <vector>
 
 class TradeService
@@ -14,21 +19,45 @@ class TradeService
 public:
     TradeService(
         std::shared_ptr<Database> database,
+        std::shared_ptr<PersistenceWriter> persistence,
         std::shared_ptr<EventLogger> eventLogger,
         std::shared_ptr<MarketService> marketService,
         std::shared_ptr<TraderService> traderService);
     ~TradeService() = default;
 
-    Trade addTrade(Order &bidOrder, Order &askOrder, int quantity);
+    Trade addTrade(const Fill &fill);
     Trade getTrade(int tradeId) const;
     std::vector<Trade> getTrades(int start = 0, int limit = -1) const;
+    // Up to `limit` trades with ids below `beforeId`, newest first. Pages by id rather than by offset, so a
+    // client walking back through history is not thrown off by trades arriving in the meantime.
+    std::vector<Trade> getTradesBefore(int beforeId, int limit = -1) const;
+    const TradeTotals &getTotals() const { return totals; }
+    int getLastTradeId() const { return tradeIds.last(); }
+
+    // Called with every trade as it is recorded, after the market price has moved to the trade price.
+    void setTradeListener(std::function<void(const Trade &)> listener) { tradeListener = std::move(listener); }
 
 private:
     std::shared_ptr<Database> database;
+    std::shared_ptr<PersistenceWriter> persistence;
     std::shared_ptr<EventLogger> eventLogger;
     std::shared_ptr<MarketService> marketService;
     std::shared_ptr<TraderService> traderService;
-    std::vector<Trade> trades;
+    // Only the most recent trades are held in memory; older ones are read from storage on request.
+    RingBuffer<Trade> recentTrades{RECENT_TRADES};
+    TradeTotals totals;
+    std::function<void(const Trade &)> tradeListener;
+    IdSequencer tradeIds;
+
+    static constexpr size_t RECENT_TRADES = 10000;
+
+    // Index of the first trade in recentTrades whose id is not below `tradeId`.
+    size_t lowerBound(int tradeId) const;
+    // Trades older than recentTrades, newest first. The writer is flushed first if any of them may still be
+    // queued.
+    std::vector<Trade> readPage(int beforeId, int limit) const;
+    void recordTotals(const Trade &trade);
+    void applyToPositions(const Trade &trade);
 };
 
 #endif
\ No newline at end of file
@@ -4,18 +4,24 @@
 #include "models/Trader.hpp"
 #include "models/Trade.hpp"
 
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <memory>
 
 class TraderService
 {
 public:
     virtual std::shared_ptr<Trader> getTrader(const std::string &traderId);
+    virtual std::shared_ptr<Trader> getTraderByIndex(uint32_t traderIndex);
     virtual void updateTradersDrawdown(double currentPrice);
 
+    std::vector<TraderState> getTraderStates() const;
+    void restoreTraders(const std::vector<TraderState> &states);
+
 private:
-    std::unordered_map<std::string, std::shared_ptr<Trader>> traders;
+    // Indexed by interned trader index; slots stay empty until the trader is first seen.
+    std::vector<std::shared_ptr<Trader>> traders;
 };
 
 #endif
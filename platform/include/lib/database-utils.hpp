@@ -2,6 +2,7 @@
 #define DATABASE_UTILS_HPP
 
 #include <optional>
+#include <string>
 #include <sqlite3.h>
 
 #define INT_FIELD(fieldName, getter, setter) { \
@@ -45,6 +46,17 @@
     } \
 }
 
+#define BLOB_FIELD(fieldName, getter, setter) { \
+    #fieldName, \
+    [](sqlite3_stmt* stmt, int idx, const auto &record) { \
+        sqlite3_bind_blob(stmt, idx, record.getter().data(), static_cast<int>(record.getter().size()), SQLITE_TRANSIENT); \
+    }, \
+    [](sqlite3_stmt* stmt, int idx, auto &record) { \
+        const void *blob = sqlite3_column_blob(stmt, idx); \
+        record.setter(blob ? std::string(static_cast<const char*>(blob), sqlite3_column_bytes(stmt, idx)) : std::string()); \
+    } \
+}
+
 #define OPTIONAL_INT_FIELD(fieldName, getter, setter) { \
     #fieldName, \
     [](sqlite3_stmt* stmt, int idx, const auto &record) { \
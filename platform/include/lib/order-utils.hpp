@@ -11,6 +11,6 @@ std::string getOrderTypeString(OrderType orderType, bool titleCase = false);
 std::string getOrderSideString(OrderSide orderSide);
 std::string getOrderStatusString(OrderStatus orderStatus);
 
-std::string formatPrice(double price);
+std::string formatPrice(Price price);
 
 #endif
\ No newline at end of file
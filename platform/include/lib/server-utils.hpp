@@ -19,11 +19,13 @@ crow::json::wvalue orderToJson(const Order &order);
 crow::json::wvalue tradeToJson(const Trade &trade);
 crow::json::wvalue traderToJson(std::shared_ptr<Trader> trader, std::shared_ptr<MarketService> market, const OrderBook &orderBook);
 crow::json::wvalue marketDataToJson(MarketData &marketData);
+crow::json::wvalue depthLevelToJson(const DepthLevel &level);
 crow::json::wvalue riskLimitsToJson(const RiskLimits &limits);
 
 std::unique_ptr<Order> createOrderFromJson(OrderType type, const crow::json::rvalue &json,
                                            OrderSide side, int quantity,
                                            const std::string &traderId);
+std::unique_ptr<Order> parseOrderJson(const crow::json::rvalue &json);
 
 template <typename Container, typename Converter>
 crow::json::wvalue::list buildJsonList(const Container &items, Converter converter)
@@ -0,0 +1,6 @@
+./build.sh
+cd ../build
+for benchmark in *Benchmark; do
+    ./$benchmark
+done
+cd ../scripts
@@ -36,15 +36,80 @@ crow::response handlePostOrders(Server &server, const crow::request &req)
 
     try
     {
-        OrderType type = parseOrderType(json["orderType"].s());
-        OrderSide side = (std::string(json["side"].s()) == "BID") ? OrderSide::BID : OrderSide::ASK;
-        int quantity = json["quantity"].i();
-        std::string traderId = json["traderId"].s();
-
-        auto order = createOrderFromJson(type, json, side, quantity, traderId);
+        auto order = parseOrderJson(json);
         server.book->addOrder(*order);
         res.code = 201;
     }
+    catch (const std::invalid_argument &ex)
+    {
+        res.code = 400;
+        res.write(ex.what());
+    }
+    catch (const std::exception &ex)
+    {
+        res.code = 500;
+        res.write(ex.what());
+    }
+    return res;
+}
+
+crow::response handlePostOrdersBatch(Server &server, const crow::request &req)
+{
+    crow::response res;
+    auto json = loadJsonOrError(req, res);
+    if (!json)
+        return res;
+
+    if (!json.has("orders") || json["orders"].t() != crow::json::type::List)
+    {
+        res.code = 400;
+        res.write("Expected an orders list");
+        return res;
+    }
+    auto ordersJson = json["orders"];
+
+    // Entries that fail to parse never reach the book; they keep their slot in the response.
+    std::vector<Order> orders;
+    std::vector<std::string> parseErrors(ordersJson.size());
+    for (size_t i = 0; i < ordersJson.size(); ++i)
+    {
+        try
+        {
+            orders.push_back(*parseOrderJson(ordersJson[i]));
+        }
+        catch (const std::exception &ex)
+        {
+            parseErrors[i] = ex.what();
+        }
+    }
+
+    try
+    {
+        auto results = server.book->addOrders(orders);
+
+        crow::json::wvalue::list resultsJson;
+        size_t accepted = 0;
+        auto result = results.begin();
+        for (const auto &parseError : parseErrors)
+        {
+            crow::json::wvalue entry;
+            if (!parseError.empty())
+                entry["error"] = parseError;
+            else if (result->accepted())
+            {
+                entry = orderToJson(*(result++)->order);
+                ++accepted;
+            }
+            else
+                entry["error"] = (result++)->error;
+            resultsJson.push_back(std::move(entry));
+        }
+
+        // A batch that placed nothing is a client error; the per-entry errors still say why.
+        crow::json::wvalue body;
+        body["results"] = std::move(resultsJson);
+        return crow::response(accepted > 0 ? 201 : 400, body);
+    }
     catch (const std::exception &ex)
     {
         res.code = 500;
@@ -86,16 +151,21 @@ crow::response handleGetTrades(Server &server, const crow::request &req)
 {
     auto qs = crow::query_string(req.url_params);
     int start = getQueryParam(qs, "start", 0);
-    int limit = getQueryParam(qs, "limit", -1);
-    auto trades = server.book->getTrades(start, limit);
+    int limit = getQueryParam(qs, "limit", 20);
+    // `before` pages by trade id: pass the id of the last trade received to get the next older page.
+    int before = getQueryParam(qs, "before", 0);
+    auto trades = before > 0 ? server.book->getTradesBefore(before, limit) : server.book->getTrades(start, limit);
 
     crow::json::wvalue res;
     res["trades"] = buildJsonList(trades, tradeToJson);
+    if (!trades.empty())
+        res["nextBefore"] = trades.back().getId();
     return crow::response(res);
 }
 
 crow::response handleGetTraderById(Server &server, const std::string &traderId)
 {
+    std::lock_guard lock(server.book->getMutex());
     auto trader = server.traderService->getTrader(traderId);
     crow::json::wvalue res;
     res["trader"] = traderToJson(trader, server.marketService, *server.book);
@@ -110,6 +180,17 @@ crow::response handleGetMarket(Server &server)
     return crow::response(res);
 }
 
+crow::response handleGetDepth(Server &server, const crow::request &req)
+{
+    auto qs = crow::query_string(req.url_params);
+    int levels = getQueryParam(qs, "levels", 10);
+
+    crow::json::wvalue res;
+    res["asks"] = buildJsonList(server.book->getDepth(OrderSide::ASK, levels), depthLevelToJson);
+    res["bids"] = buildJsonList(server.book->getDepth(OrderSide::BID, levels), depthLevelToJson);
+    return crow::response(res);
+}
+
 crow::response handlePutRisk(Server &server, const crow::request &req)
 {
     crow::response res;
@@ -124,6 +205,7 @@ crow::response handlePutRisk(Server &server, const crow::request &req)
         return res;
     }
 
+    std::lock_guard lock(server.book->getMutex());
     std::string scope = json["scope"].s();
     RiskLimits limits;
     if (scope == "GLOBAL")
@@ -175,7 +257,11 @@ crow::response handleGetRisk(Server &server, const crow::request &req)
     crow::json::wvalue res;
     auto qs = crow::query_string(req.url_params);
     std::string traderId = qs.get("traderId") ? qs.get("traderId") : "";
-    RiskLimits limits = server.riskService->getEffectiveLimits(traderId);
+    RiskLimits limits;
+    {
+        std::lock_guard lock(server.book->getMutex());
+        limits = server.riskService->getEffectiveLimits(traderId);
+    }
     res["limits"] = riskLimitsToJson(limits);
     
     return crow::response(res);
@@ -9,13 +9,13 @@
 #include <functional>
 #include <thread>
 
-Server::Server(const std::string &dbFilePath)
-    : database(std::make_shared<Database>(dbFilePath)),
+Server::Server(const std::string &dbFilePath, StorageOptions storageOptions, PersistenceOptions persistenceOptions)
+    : database(Database::open(dbFilePath, storageOptions)),
       eventLogger(std::make_shared<EventLogger>()),
       traderService(std::make_shared<TraderService>()),
       marketService(std::make_shared<MarketService>(traderService)),
       riskService(std::make_shared<RiskService>(eventLogger, traderService)),
-      book(std::make_shared<OrderBook>(database, eventLogger, marketService, riskService, traderService))
+      book(std::make_shared<OrderBook>(database, eventLogger, marketService, riskService, traderService, persistenceOptions))
 {
 }
 
@@ -40,6 +40,8 @@ void Server::setupRoutes()
 {
     CROW_ROUTE(app, "/orders").methods("POST"_method)([this](const crow::request &req)
                                                       { return handlePostOrders(*this, req); });
+    CROW_ROUTE(app, "/orders/batch").methods("POST"_method)([this](const crow::request &req)
+                                                            { return handlePostOrdersBatch(*this, req); });
     CROW_ROUTE(app, "/orders").methods("GET"_method)([this](const crow::request &req)
                                                      { return handleGetOrders(*this, req); });
     CROW_ROUTE(app, "/orders/<int>").methods("DELETE"_method)([this](int orderId)
@@ -50,6 +52,8 @@ void Server::setupRoutes()
                                                                { return handleGetTraderById(*this, traderId); });
     CROW_ROUTE(app, "/market").methods("GET"_method)([this]()
                                                      { return handleGetMarket(*this); });
+    CROW_ROUTE(app, "/market/depth").methods("GET"_method)([this](const crow::request &req)
+                                                           { return handleGetDepth(*this, req); });
     CROW_ROUTE(app, "/risk").methods("PUT"_method)([this](const crow::request &req)
                                                    { return handlePutRisk(*this, req); });
     CROW_ROUTE(app, "/risk").methods("GET"_method)([this](const crow::request &req)
@@ -129,8 +133,8 @@ void Server::processEvents()
             data["data"]["order"]["status"] = getOrderStatusString(order.getStatus());
             data["data"]["order"]["quantity"] = order.getRemainingQuantity();
             data["data"]["order"]["traderId"] = order.getTraderId();
-            if (order.getPrice() != -1)
-                data["data"]["order"]["price"] = order.getPrice();
+            if (order.getPrice().isSet())
+                data["data"]["order"]["price"] = order.getPrice().toDouble();
 
             data["data"]["asks"]["active"] = buildJsonList(book->getActiveAsks(0, 20), orderToJson);
             data["data"]["bids"]["active"] = buildJsonList(book->getActiveBids(0, 20), orderToJson);
@@ -160,6 +164,7 @@ void Server::processEvents()
         case EventType::RISK_UPDATED:
         {
             auto riskEvent = std::dynamic_pointer_cast<RiskEvent>(event);
+            std::lock_guard lock(book->getMutex());
             RiskEvent::Scope scope = riskEvent->getScope();
 
             if (scope == RiskEvent::Scope::TRADER)
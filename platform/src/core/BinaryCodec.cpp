@@ -0,0 +1,49 @@
+#include "BinaryCodec.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+void writeFileAtomically(const std::string &path, std::string_view contents)
+{
+    std::string temporaryPath = path + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Failed to open " + temporaryPath + ": " + std::strerror(errno));
+
+    size_t written = 0;
+    while (written < contents.size())
+    {
+        ssize_t result = ::write(fd, contents.data() + written, contents.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            ::close(fd);
+            throw std::runtime_error("Failed to write " + temporaryPath + ": " + std::strerror(errno));
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    if (::fsync(fd) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Failed to sync " + temporaryPath + ": " + std::strerror(errno));
+    }
+    ::close(fd);
+
+    std::filesystem::rename(temporaryPath, path);
+}
+
+std::optional<std::string> readFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return std::nullopt;
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
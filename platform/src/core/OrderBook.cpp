@@ -1,5 +1,6 @@
 #include "OrderBook.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 OrderBook::OrderBook(
@@ -7,36 +8,65 @@ OrderBook::OrderBook(
     std::shared_ptr<EventLogger> eventLogger,
     std::shared_ptr<MarketService> marketService,
     std::shared_ptr<RiskService> riskService,
-    std::shared_ptr<TraderService> traderService)
+    std::shared_ptr<TraderService> traderService,
+    PersistenceOptions persistenceOptions)
     : database(database),
       eventLogger(eventLogger),
       marketService(marketService),
       traderService(traderService),
       riskService(riskService),
-      tradeService(std::make_shared<TradeService>(database, eventLogger, marketService, traderService)),
-      activeOrderService(std::make_unique<ActiveOrderService>(database, eventLogger, tradeService, traderService)),
-      conditionalOrderService(std::make_unique<ConditionalOrderService>(eventLogger))
+      persistence(std::make_shared<PersistenceWriter>(database, persistenceOptions)),
+      tradeService(std::make_shared<TradeService>(database, persistence, eventLogger, marketService, traderService)),
+      orderIds(database->orders()->getLastId()),
+      activeOrderService(std::make_unique<ActiveOrderService>(database, persistence, eventLogger, tradeService, traderService)),
+      conditionalOrderService(std::make_unique<ConditionalOrderService>(database, persistence, eventLogger))
 {
+    // Positions are stored as they change, so a restart restores every trader in one pass over storage.
+    traderService->restoreTraders(database->traders()->getAll());
+
+    // Stops are checked against each trade print as the matcher settles, so a sweep through several levels
+    // fires them at the prices it actually traded through. They are only queued here; entering them waits
+    // until the match that fired them has finished.
+    tradeService->setTradeListener([this](const Trade &trade)
+                                   { queueTriggeredOrders(trade.getPrice(), cascadeDepth + 1); });
 }
 
 Order OrderBook::addOrder(Order &order)
 {
-    if (!riskService->checkOrder(order, marketService->getCurrentPrice()))
+    {
+        std::lock_guard lock(mutex);
+        processOrder(order);
+    }
+    persistence->sync();
+    return order;
+}
+
+void OrderBook::processOrder(Order &order)
+{
+    cascadeDepth = 0;
+    enterOrder(order);
+    queueTriggeredOrders(marketService->getCurrentPrice(), 1);
+    runCascade();
+}
+
+void OrderBook::enterOrder(Order &order)
+{
+    if (!riskService->checkOrder(order, marketService->getCurrentPrice().toDouble()))
     {
         eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_REJECTED, order, generateOrderRejectedMessage(order)));
         throw std::runtime_error("Order rejected due to risk limits");
     }
 
-    auto trader = traderService->getTrader(order.getTraderId());
+    auto trader = traderService->getTraderByIndex(order.getTraderIndex());
     if (order.getSide() == OrderSide::ASK)
     {
         if (!trader->placeOrder(order))
             throw std::runtime_error("Trader " + order.getTraderId() + ": Insufficient inventory for sale");
+        persistence->updateTrader(trader->getState());
     }
 
-    auto orderId = database->orders()->create(order);
-
-    order.setId(orderId);
+    order.setId(orderIds.next());
+    persistence->insertOrder(order);
 
     if (
         order.getType() == OrderType::STOP ||
@@ -45,47 +75,151 @@ Order OrderBook::addOrder(Order &order)
         conditionalOrderService->addOrder(order);
     else
     {
-        activeOrderService->addOrder(order);
+        order = activeOrderService->addOrder(order);
     }
+}
+
+void OrderBook::saveSnapshot(const std::string &path)
+{
+    BookSnapshot snapshot;
+    {
+        std::lock_guard lock(mutex);
+        snapshot = BookSnapshot{tradeService->getLastTradeId(), marketService->getState()};
+
+        // Every price move updates every trader's drawdown, but only the traders in a trade are written with
+        // it, so the rest are brought up to date here.
+        for (const auto &state : traderService->getTraderStates())
+            persistence->updateTrader(state);
+    }
+
+    // Storage has to hold every trade up to the snapshot's last trade id before the snapshot can point at it.
+    persistence->flush();
+    {
+        std::lock_guard lock(database->getMutex());
+        database->checkpoint();
+    }
+    snapshot.save(path);
+}
+
+bool OrderBook::loadSnapshot(const std::string &path)
+{
+    std::lock_guard lock(mutex);
+    auto snapshot = BookSnapshot::load(path);
+    if (!snapshot)
+        return false;
+
+    // Positions were already restored from storage; the later trades only have to move the market on.
+    marketService->restoreState(snapshot->market);
+    for (const auto &trade : database->trades()->getSince(snapshot->lastTradeId))
+        marketService->updatePrice(trade.getPrice());
+    return true;
+}
 
-    auto triggeredOrders = conditionalOrderService->triggerOrders(marketService->getCurrentPrice());
-    for (const auto &triggeredOrder : triggeredOrders)
+void OrderBook::queueTriggeredOrders(Price currentMarketPrice, size_t depth)
+{
+    triggeredOrders.clear();
+    conditionalOrderService->triggerOrders(currentMarketPrice, triggeredOrders);
+    for (auto &triggeredOrder : triggeredOrders)
+        triggerQueue.push_back({std::move(triggeredOrder), depth});
+}
+
+// Enters triggered orders breadth-first, checking for new triggers after each one, until the queue drains
+// or the cascade limit is reached. Orders still queued at the limit go back to the conditional book.
+void OrderBook::runCascade()
+{
+    size_t size = 0;
+    size_t depth = 0;
+
+    while (!triggerQueue.empty())
     {
-        if (triggeredOrder->getType() == OrderType::STOP_LIMIT)
+        if (size == cascadeLimit)
         {
-            auto payload = LimitOrder(triggeredOrder->getSide(), triggeredOrder->getInitialQuantity(), triggeredOrder->getTraderId(), triggeredOrder->getLimitPrice());
-            auto triggeredOrder = addOrder(payload);
+            cascadeStats.deferred += triggerQueue.size();
+            for (const auto &deferred : triggerQueue)
+                conditionalOrderService->restoreOrder(deferred.order);
+            triggerQueue.clear();
+            break;
         }
-        else
+
+        auto [triggeredOrder, triggeredDepth] = std::move(triggerQueue.front());
+        triggerQueue.pop_front();
+        ++size;
+        depth = std::max(depth, triggeredDepth);
+        cascadeDepth = triggeredDepth;
+
+        Order payload = (triggeredOrder->getType() == OrderType::STOP_LIMIT)
+                            ? Order(OrderType::LIMIT, triggeredOrder->getSide(), triggeredOrder->getInitialQuantity(), triggeredOrder->getTraderId(), triggeredOrder->getLimitPrice())
+                            : MarketOrder(triggeredOrder->getSide(), triggeredOrder->getInitialQuantity(), triggeredOrder->getTraderId());
+        try
+        {
+            enterOrder(payload);
+        }
+        catch (const std::runtime_error &)
         {
-            auto payload = MarketOrder(triggeredOrder->getSide(), triggeredOrder->getInitialQuantity(), triggeredOrder->getTraderId());
-            auto triggeredOrder = addOrder(payload);
+            // Refused by risk or inventory checks; the rest of the cascade still runs.
         }
+
+        queueTriggeredOrders(marketService->getCurrentPrice(), triggeredDepth + 1);
     }
 
-    return order;
+    if (size == 0)
+        return;
+
+    ++cascadeStats.cascades;
+    cascadeStats.lastDepth = depth;
+    cascadeStats.lastSize = size;
+    cascadeStats.maxDepth = std::max(cascadeStats.maxDepth, depth);
+    cascadeStats.maxSize = std::max(cascadeStats.maxSize, size);
+}
+
+std::vector<BatchOrderResult> OrderBook::addOrders(std::span<Order> orders)
+{
+    std::vector<BatchOrderResult> results;
+    results.reserve(orders.size());
+
+    // Orders are risk-checked and matched one at a time, in the order given, so a refused order does not
+    // affect the rest of the batch. Everything the batch writes is committed by the writer in one
+    // transaction, so nothing waits on a commit until the batch has ended; the writer holds it back until
+    // then.
+    {
+        std::lock_guard lock(mutex);
+        persistence->beginBatch();
+        for (auto &order : orders)
+        {
+            try
+            {
+                processOrder(order);
+                results.push_back({order, ""});
+            }
+            catch (const std::exception &ex)
+            {
+                results.push_back({std::nullopt, ex.what()});
+            }
+        }
+        persistence->endBatch();
+    }
+    persistence->sync();
+
+    return results;
 }
 
 std::vector<Order> OrderBook::getActiveAsks(int start, int limit) const
 {
-    std::vector<Order> result;
-    auto asksPtr = activeOrderService->getAsks(start, limit);
-    for (const auto &orderPtr : asksPtr)
-        result.push_back(*orderPtr);
-    return result;
+    std::lock_guard lock(mutex);
+    auto asks = activeOrderService->getAsks(start, limit);
+    return std::vector<Order>(asks.begin(), asks.end());
 }
 
 std::vector<Order> OrderBook::getActiveBids(int start, int limit) const
 {
-    std::vector<Order> result;
-    auto bidsPtr = activeOrderService->getBids(start, limit);
-    for (const auto &orderPtr : bidsPtr)
-        result.push_back(*orderPtr);
-    return result;
+    std::lock_guard lock(mutex);
+    auto bids = activeOrderService->getBids(start, limit);
+    return std::vector<Order>(bids.begin(), bids.end());
 }
 
 std::vector<Order> OrderBook::getConditionalAsks(int start, int limit) const
 {
+    std::lock_guard lock(mutex);
     std::vector<Order> result;
     auto asksPtr = conditionalOrderService->getAsks(start, limit);
     for (const auto &orderPtr : asksPtr)
@@ -95,6 +229,7 @@ std::vector<Order> OrderBook::getConditionalAsks(int start, int limit) const
 
 std::vector<Order> OrderBook::getConditionalBids(int start, int limit) const
 {
+    std::lock_guard lock(mutex);
     std::vector<Order> result;
     auto bidsPtr = conditionalOrderService->getBids(start, limit);
     for (const auto &orderPtr : bidsPtr)
@@ -104,20 +239,40 @@ std::vector<Order> OrderBook::getConditionalBids(int start, int limit) const
 
 std::vector<Trade> OrderBook::getTrades(int start, int limit) const
 {
+    std::lock_guard lock(mutex);
     return tradeService->getTrades(start, limit);
 }
 
+std::vector<Trade> OrderBook::getTradesBefore(int beforeId, int limit) const
+{
+    std::lock_guard lock(mutex);
+    return tradeService->getTradesBefore(beforeId, limit);
+}
+
+std::vector<DepthLevel> OrderBook::getDepth(OrderSide side, int levels) const
+{
+    std::lock_guard lock(mutex);
+    return activeOrderService->getDepth(side, levels);
+}
+
 bool OrderBook::cancelOrder(int orderId)
+{
+    bool cancelled = false;
+    {
+        std::lock_guard lock(mutex);
+        cancelled = cancelLocked(orderId);
+    }
+    if (cancelled)
+        persistence->sync();
+    return cancelled;
+}
+
+bool OrderBook::cancelLocked(int orderId)
 {
     try
     {
-        auto order = activeOrderService->getOrder(orderId);
         if (activeOrderService->cancelOrder(orderId))
-        {
-            order->setStatus(OrderStatus::CANCELLED);
-            database->orders()->update(*order);
             return true;
-        }
     }
     catch (std::runtime_error &)
     {
@@ -129,7 +284,7 @@ bool OrderBook::cancelOrder(int orderId)
         if (conditionalOrderService->cancelOrder(orderId))
         {
             order->setStatus(OrderStatus::CANCELLED);
-            database->orders()->update(*order);
+            persistence->updateOrder(*order);
             return true;
         }
     }
@@ -143,55 +298,53 @@ bool OrderBook::cancelOrder(int orderId)
 
 bool OrderBook::modifyOrder(int orderId, double newPrice, int newQuantity)
 {
-    auto oldOrder = activeOrderService->getOrder(orderId);
-
-    Order modifiedAttempt(oldOrder->getType(), oldOrder->getSide(), newQuantity, oldOrder->getTraderId(), newPrice);
-    if (!riskService->checkOrder(modifiedAttempt, marketService->getCurrentPrice()))
-        return false;
+    {
+        std::lock_guard lock(mutex);
+        const auto &oldOrder = activeOrderService->getOrder(orderId);
 
-    bool result = activeOrderService->modifyOrder(orderId, newPrice, newQuantity);
-    if (!result)
-        return false;
+        Order modifiedAttempt(oldOrder.getType(), oldOrder.getSide(), newQuantity, oldOrder.getTraderId(), Price::fromDouble(newPrice));
+        if (!riskService->checkOrder(modifiedAttempt, marketService->getCurrentPrice().toDouble()))
+            return false;
 
-    auto modifiedOrder = activeOrderService->getOrder(orderId);
-    database->orders()->update(*modifiedOrder);
+        if (!activeOrderService->modifyOrder(orderId, modifiedAttempt.getPrice(), newQuantity))
+            return false;
+    }
 
+    persistence->sync();
     return true;
 }
 
 void OrderBook::updateMarketPrice(double currentMarketPrice, double volatility)
 {
-    auto triggered = conditionalOrderService->triggerOrders(currentMarketPrice);
-    for (const auto &order : triggered)
     {
-        if (order->getType() == OrderType::STOP_LIMIT)
-        {
-            auto payload = LimitOrder(order->getSide(), order->getInitialQuantity(), order->getTraderId(), order->getLimitPrice());
-            auto triggeredOrder = addOrder(payload);
-        }
-        else
-        {
-            auto payload = MarketOrder(order->getSide(), order->getInitialQuantity(), order->getTraderId());
-            auto triggeredOrder = addOrder(payload);
-        }
+        std::lock_guard lock(mutex);
+        queueTriggeredOrders(Price::fromDouble(currentMarketPrice), 1);
+        runCascade();
     }
+    persistence->sync();
+}
+
+void OrderBook::saveTrailingStops()
+{
+    std::lock_guard lock(mutex);
+    conditionalOrderService->saveTrailingStops();
 }
 
 Order OrderBook::getBestBid() const
 {
-    return *activeOrderService->getBestBid();
+    std::lock_guard lock(mutex);
+    return activeOrderService->getBestBid();
 }
 
 Order OrderBook::getBestAsk() const
 {
-    return *activeOrderService->getBestAsk();
+    std::lock_guard lock(mutex);
+    return activeOrderService->getBestAsk();
 }
 
 MarketData OrderBook::getMarketData() const
 {
-    auto asks = getActiveAsks();
-    auto bids = getActiveBids();
-
+    std::lock_guard lock(mutex);
     MarketData data;
     data.marketPrice = marketService->getCurrentPrice();
     data.volatility = marketService->getVolatility();
@@ -214,31 +367,25 @@ MarketData OrderBook::getMarketData() const
         data.bids.best = std::nullopt;
     }
 
-    data.asks.count = asks.size();
-    data.bids.count = bids.size();
-
-    data.asks.volume = 0;
-    for (const auto &order : asks)
-        data.asks.volume += order.getRemainingQuantity();
+    const auto &askTotals = activeOrderService->getTotals(OrderSide::ASK);
+    const auto &bidTotals = activeOrderService->getTotals(OrderSide::BID);
 
-    data.bids.volume = 0;
-    for (const auto &order : bids)
-        data.bids.volume += order.getRemainingQuantity();
+    data.asks.count = askTotals.orderCount;
+    data.asks.volume = askTotals.quantity;
+    data.bids.count = bidTotals.orderCount;
+    data.bids.volume = bidTotals.quantity;
 
-    data.trades.count = tradeService->getTrades().size();
-    data.trades.volume = 0;
-    for (const auto &trade : tradeService->getTrades())
-        data.trades.volume += trade.getQuantity();
-    double totalTradeValue = 0;
-    for (const auto &trade : tradeService->getTrades())
-        totalTradeValue += trade.getQuantity() * trade.getPrice();
-    data.trades.avgPrice = data.trades.volume > 0 ? totalTradeValue / data.trades.volume : -1;
+    const auto &tradeTotals = tradeService->getTotals();
+    data.trades.count = tradeTotals.count;
+    data.trades.volume = tradeTotals.volume;
+    data.trades.avgPrice = tradeTotals.volume > 0 ? tradeTotals.notional / tradeTotals.volume : -1;
 
     return data;
 }
 
 OrderCounts OrderBook::countOrdersForTrader(const std::string &traderId) const
 {
+    std::lock_guard lock(mutex);
     auto activeCounts = activeOrderService->countOrdersForTrader(traderId);
     auto conditionalCounts = conditionalOrderService->countOrdersForTrader(traderId);
 
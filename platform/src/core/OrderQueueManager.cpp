@@ -1,91 +1,300 @@
 #include "OrderQueueManager.hpp"
 
-void OrderQueueManager::addOrder(const std::shared_ptr<Order> &order)
+#include <stdexcept>
+
+void OrderList::insert(OrderEntry *position, OrderEntry *entry)
 {
-    orderMap.emplace(order->getId(), order);
-    if (order->getSide() == OrderSide::BID)
-        bidQueue.push(order);
+    entry->next = position;
+    entry->prev = position ? position->prev : tail;
+
+    if (entry->prev)
+        entry->prev->next = entry;
+    else
+        head = entry;
+
+    if (position)
+        position->prev = entry;
     else
-        askQueue.push(order);
+        tail = entry;
 }
 
-void OrderQueueManager::storeOrder(const std::shared_ptr<Order> &order)
+void OrderList::erase(OrderEntry *entry)
 {
-    orderMap.emplace(order->getId(), order);
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        head = entry->next;
+
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        tail = entry->prev;
+
+    entry->prev = nullptr;
+    entry->next = nullptr;
 }
 
-void OrderQueueManager::enqueueOrder(const std::shared_ptr<Order> &order)
+OrderRange::iterator::iterator(PriceLevels::const_iterator level, PriceLevels::const_iterator levelsEnd,
+                               const OrderEntry *node, int remaining)
+    : level(level), levelsEnd(levelsEnd), node(remaining == 0 ? nullptr : node), remaining(remaining)
 {
-    if (order->getSide() == OrderSide::BID)
-        bidQueue.push(order);
-    else
-        askQueue.push(order);
 }
 
-void OrderQueueManager::removeOrder(int orderId, OrderSide side)
+OrderRange::iterator &OrderRange::iterator::operator++()
+{
+    node = node->next;
+    while (!node && ++level != levelsEnd)
+        node = level->second.orders.first();
+
+    if (remaining > 0 && --remaining == 0)
+        node = nullptr;
+    return *this;
+}
+
+OrderRange::OrderRange(const PriceLevels &levels, int start, int limit)
 {
-    OrderQueue newQueue;
-    OrderQueue &queue = (side == OrderSide::BID) ? bidQueue : askQueue;
-    while (!queue.empty())
+    // Whole levels before the page are skipped using their cached order counts.
+    auto level = levels.begin();
+    while (level != levels.end() && start >= level->second.orderCount)
     {
-        auto ord = queue.top();
-        queue.pop();
-        if (ord->getId() != orderId)
-            newQueue.push(ord);
+        start -= level->second.orderCount;
+        ++level;
     }
-    queue = std::move(newQueue);
-    orderMap.erase(orderId);
+    if (level == levels.end())
+        return;
+
+    const OrderEntry *node = level->second.orders.first();
+    while (start-- > 0)
+        node = node->next;
+
+    first = iterator(level, levels.end(), node, limit);
+}
+
+OrderHandle OrderQueueManager::addOrder(const Order &order)
+{
+    auto handle = storeOrder(order);
+    enqueueOrder(handle);
+    return handle;
+}
+
+OrderHandle OrderQueueManager::storeOrder(const Order &order)
+{
+    auto handle = entries.allocate(order);
+    entries.get(handle)->handle = handle;
+    orderMap[order.getId()] = handle;
+    return handle;
+}
+
+void OrderQueueManager::enqueueOrder(OrderHandle handle)
+{
+    auto &entry = entryAt(handle);
+    if (entry.queued)
+        return;
+
+    const auto &order = entry.order;
+    auto &levels = levelsFor(order.getSide());
+    auto level = levels.try_emplace(order.getPrice()).first;
+    auto &orders = level->second.orders;
+
+    // Time priority is by id, so orders returning to the book (e.g. skipped or modified) reclaim their original slot.
+    OrderEntry *position = nullptr;
+    OrderEntry *candidate = orders.last();
+    while (candidate && candidate->order.getId() > order.getId())
+    {
+        position = candidate;
+        candidate = candidate->prev;
+    }
+
+    orders.insert(position, &entry);
+    entry.level = level;
+    entry.queued = true;
+    entry.queuedQuantity = order.getRemainingQuantity();
+
+    level->second.totalQuantity += entry.queuedQuantity;
+    ++level->second.orderCount;
+
+    auto &totals = totalsFor(order.getSide());
+    totals.quantity += entry.queuedQuantity;
+    ++totals.orderCount;
+    countQueued(order, 1);
+}
+
+void OrderQueueManager::dequeueOrder(OrderHandle handle)
+{
+    auto *entryPtr = entries.get(handle);
+    if (!entryPtr || !entryPtr->queued)
+        return;
+
+    auto &entry = *entryPtr;
+    auto &level = entry.level->second;
+    level.orders.erase(&entry);
+    level.totalQuantity -= entry.queuedQuantity;
+    --level.orderCount;
+
+    auto &totals = totalsFor(entry.order.getSide());
+    totals.quantity -= entry.queuedQuantity;
+    --totals.orderCount;
+    countQueued(entry.order, -1);
+
+    if (level.orders.empty())
+        levelsFor(entry.order.getSide()).erase(entry.level);
+    entry.queued = false;
+    entry.queuedQuantity = 0;
+}
+
+void OrderQueueManager::removeOrder(int orderId)
+{
+    releaseOrder(findOrder(orderId));
+}
+
+void OrderQueueManager::releaseOrder(OrderHandle handle)
+{
+    auto *entry = entries.get(handle);
+    if (!entry)
+        return;
+
+    dequeueOrder(handle);
+    orderMap.erase(entry->order.getId());
+    entries.release(handle);
+}
+
+void OrderQueueManager::updateQuantity(OrderHandle handle, int remainingQuantity)
+{
+    auto &entry = entryAt(handle);
+    entry.order.setRemainingQuantity(remainingQuantity);
+    if (!entry.queued)
+        return;
+
+    int change = remainingQuantity - entry.queuedQuantity;
+    entry.level->second.totalQuantity += change;
+    totalsFor(entry.order.getSide()).quantity += change;
+    entry.queuedQuantity = remainingQuantity;
+}
+
+const PriceLevels &OrderQueueManager::getLevels(OrderSide side) const
+{
+    return (side == OrderSide::BID) ? bidLevels : askLevels;
+}
+
+OrderEntry &OrderQueueManager::entryAt(OrderHandle handle)
+{
+    auto *entry = entries.get(handle);
+    if (!entry)
+        throw std::runtime_error("Order not found");
+    return *entry;
 }
 
-OrderQueue &OrderQueueManager::getQueue(OrderSide side)
+PriceLevels &OrderQueueManager::levelsFor(OrderSide side)
 {
-    return (side == OrderSide::BID) ? bidQueue : askQueue;
+    return (side == OrderSide::BID) ? bidLevels : askLevels;
 }
 
-std::shared_ptr<Order> OrderQueueManager::getOrder(int orderId) const
+SideTotals &OrderQueueManager::totalsFor(OrderSide side)
+{
+    return (side == OrderSide::BID) ? bidTotals : askTotals;
+}
+
+const SideTotals &OrderQueueManager::getTotals(OrderSide side) const
+{
+    return (side == OrderSide::BID) ? bidTotals : askTotals;
+}
+
+void OrderQueueManager::countQueued(const Order &order, int change)
+{
+    if (order.getTraderIndex() >= queuedByTrader.size())
+        queuedByTrader.resize(order.getTraderIndex() + 1);
+
+    auto &counts = queuedByTrader[order.getTraderIndex()];
+    (order.getSide() == OrderSide::BID ? counts.bids : counts.asks) += change;
+}
+
+int OrderQueueManager::getQueuedOrderCount(uint32_t traderIndex, OrderSide side) const
+{
+    if (traderIndex >= queuedByTrader.size())
+        return 0;
+    const auto &counts = queuedByTrader[traderIndex];
+    return (side == OrderSide::BID) ? counts.bids : counts.asks;
+}
+
+OrderHandle OrderQueueManager::getFrontOrder(OrderSide side) const
+{
+    const auto &levels = getLevels(side);
+    if (levels.empty())
+        return OrderHandle();
+    return levels.begin()->second.orders.first()->handle;
+}
+
+OrderHandle OrderQueueManager::getNextOrder(OrderHandle handle) const
+{
+    const auto *entry = entries.get(handle);
+    if (!entry || !entry->queued)
+        return OrderHandle();
+    if (entry->next)
+        return entry->next->handle;
+
+    auto level = std::next(PriceLevels::const_iterator(entry->level));
+    if (level == getLevels(entry->order.getSide()).end())
+        return OrderHandle();
+    return level->second.orders.first()->handle;
+}
+
+OrderHandle OrderQueueManager::findOrder(int orderId) const
 {
     auto it = orderMap.find(orderId);
-    if (it != orderMap.end())
-        return it->second;
-    throw std::runtime_error("Order not found");
+    return (it != orderMap.end()) ? it->second : OrderHandle();
+}
+
+Order *OrderQueueManager::getOrder(OrderHandle handle)
+{
+    auto *entry = entries.get(handle);
+    return entry ? &entry->order : nullptr;
+}
+
+const Order *OrderQueueManager::getOrder(OrderHandle handle) const
+{
+    const auto *entry = entries.get(handle);
+    return entry ? &entry->order : nullptr;
+}
+
+Order &OrderQueueManager::getOrder(int orderId)
+{
+    return entryAt(findOrder(orderId)).order;
+}
+
+OrderRange OrderQueueManager::getOrders(OrderSide side, int start, int limit) const
+{
+    return OrderRange(getLevels(side), start, limit);
 }
 
-std::vector<std::shared_ptr<Order>> OrderQueueManager::getOrders(OrderSide side, int start, int limit) const
+std::vector<DepthLevel> OrderQueueManager::getDepth(OrderSide side, int levels) const
 {
-    std::vector<std::shared_ptr<Order>> orders;
-    OrderQueue queueCopy = (side == OrderSide::BID) ? bidQueue : askQueue;
-    int index = 0;
-    while (!queueCopy.empty() && (limit == -1 || orders.size() < static_cast<size_t>(limit)))
+    std::vector<DepthLevel> depth;
+    for (const auto &[price, level] : getLevels(side))
     {
-        auto order = queueCopy.top();
-        queueCopy.pop();
-        if (index >= start)
-            orders.push_back(order);
-        ++index;
+        if (levels != -1 && depth.size() >= static_cast<size_t>(levels))
+            break;
+        depth.push_back({price, level.totalQuantity, level.orderCount});
     }
-    return orders;
+    return depth;
 }
 
-std::shared_ptr<Order> OrderQueueManager::getBestOrder(OrderSide side) const
+const Order &OrderQueueManager::getBestOrder(OrderSide side) const
 {
-    OrderQueue queueCopy = (side == OrderSide::BID) ? bidQueue : askQueue;
-    while (!queueCopy.empty())
+    for (const auto &[price, level] : getLevels(side))
     {
-        auto topOrder = queueCopy.top();
-        if (orderMap.find(topOrder->getId()) != orderMap.end() && topOrder->getPrice() > 0)
-            return topOrder;
-        queueCopy.pop();
+        if (price.isSet())
+            return level.orders.first()->order;
     }
     throw std::runtime_error("No valid order available.");
 }
 
-const std::unordered_map<int, std::shared_ptr<Order>> &OrderQueueManager::getOrderMap() const
+const OrderMap &OrderQueueManager::getOrderMap() const
 {
     return orderMap;
 }
 
-void OrderQueueManager::updateOrderInBook(const std::shared_ptr<Order> &order)
+void OrderQueueManager::updateOrderInBook(OrderHandle handle)
 {
-    removeOrder(order->getId(), order->getSide());
-    addOrder(order);
+    dequeueOrder(handle);
+    enqueueOrder(handle);
 }
@@ -0,0 +1,41 @@
+#include "Snapshot.hpp"
+#include "BinaryCodec.hpp"
+
+namespace
+{
+    constexpr uint64_t SNAPSHOT_MAGIC = 0x3250414e5341444dULL; // "MDASNAP2"
+}
+
+void BookSnapshot::save(const std::string &path) const
+{
+    Encoder encoder;
+    encoder.put(SNAPSHOT_MAGIC)
+        .put(lastTradeId)
+        .put(market.currentPrice.getTicks())
+        .put(market.volatility)
+        .put(static_cast<uint64_t>(market.priceHistory.size()));
+    for (double price : market.priceHistory)
+        encoder.put(price);
+
+    writeFileAtomically(path, encoder.take());
+}
+
+std::optional<BookSnapshot> BookSnapshot::load(const std::string &path)
+{
+    auto contents = readFile(path);
+    if (!contents)
+        return std::nullopt;
+
+    Decoder decoder(*contents);
+    if (decoder.get<uint64_t>() != SNAPSHOT_MAGIC)
+        throw std::runtime_error("Not a book snapshot: " + path);
+
+    BookSnapshot snapshot;
+    snapshot.lastTradeId = decoder.get<int>();
+    snapshot.market.currentPrice = Price::fromTicks(decoder.get<int64_t>());
+    snapshot.market.volatility = decoder.get<double>();
+    auto historySize = decoder.get<uint64_t>();
+    for (uint64_t i = 0; i < historySize; ++i)
+        snapshot.market.priceHistory.push_back(decoder.get<double>());
+    return snapshot;
+}
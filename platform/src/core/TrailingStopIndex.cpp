@@ -0,0 +1,138 @@
+#include "TrailingStopIndex.hpp"
+
+void TrailingStopIndex::addOrder(const std::shared_ptr<Order> &order)
+{
+    int64_t waterMark = normalize(order->getBestPrice());
+    auto [groupIt, inserted] = groups.try_emplace(waterMark);
+    Group &group = groupIt->second;
+    group.waterMark = waterMark;
+
+    if (!inserted)
+        unindexTrigger(group);
+    auto member = group.members.emplace(order->getPrice().getTicks(), order);
+    indexTrigger(group);
+
+    locations[order->getId()] = Location{&group, member};
+}
+
+std::shared_ptr<Order> TrailingStopIndex::findOrder(int orderId) const
+{
+    auto it = locations.find(orderId);
+    if (it == locations.end())
+        return nullptr;
+
+    const auto &[group, member] = it->second;
+    syncBestPrice(*group, *member->second);
+    return member->second;
+}
+
+std::shared_ptr<Order> TrailingStopIndex::removeOrder(int orderId)
+{
+    auto it = locations.find(orderId);
+    if (it == locations.end())
+        return nullptr;
+
+    auto [group, member] = it->second;
+    locations.erase(it);
+
+    auto order = member->second;
+    syncBestPrice(*group, *order);
+
+    unindexTrigger(*group);
+    group->members.erase(member);
+    if (group->members.empty())
+        groups.erase(group->waterMark);
+    else
+        indexTrigger(*group);
+
+    return order;
+}
+
+void TrailingStopIndex::triggerOrders(Price currentMarketPrice, std::vector<std::shared_ptr<Order>> &triggeredOrders)
+{
+    int64_t price = normalize(currentMarketPrice);
+    raiseWaterMark(price);
+
+    while (!triggers.empty() && triggers.begin()->first >= price)
+    {
+        Group &group = groups.find(triggers.begin()->second)->second;
+        triggers.erase(triggers.begin());
+
+        auto member = group.members.begin();
+        while (member != group.members.end() && member->first <= group.waterMark - price)
+        {
+            auto &order = member->second;
+            syncBestPrice(group, *order);
+            triggeredOrders.push_back(order);
+            locations.erase(order->getId());
+            member = group.members.erase(member);
+        }
+
+        if (group.members.empty())
+            groups.erase(group.waterMark);
+        else
+            indexTrigger(group);
+    }
+}
+
+void TrailingStopIndex::forEachOrder(const std::function<bool(const std::shared_ptr<Order> &)> &visit) const
+{
+    for (const auto &[waterMark, group] : groups)
+    {
+        for (const auto &[offset, order] : group.members)
+        {
+            syncBestPrice(group, *order);
+            if (!visit(order))
+                return;
+        }
+    }
+}
+
+// Every group at or below the new price now shares it as a water mark, so they collapse into the largest
+// of them. Only the smaller groups' orders have their locations rewritten, so an order is moved at most
+// O(log n) times over its life.
+void TrailingStopIndex::raiseWaterMark(int64_t waterMark)
+{
+    auto end = groups.upper_bound(waterMark);
+    if (groups.begin() == end || (std::next(groups.begin()) == end && groups.begin()->first == waterMark))
+        return;
+
+    auto largest = groups.begin();
+    for (auto it = groups.begin(); it != end; ++it)
+        if (it->second.members.size() > largest->second.members.size())
+            largest = it;
+
+    auto node = groups.extract(largest);
+    Group &target = node.mapped();
+    unindexTrigger(target);
+
+    for (auto it = groups.begin(); it != groups.end() && it->first <= waterMark;)
+    {
+        Group &source = it->second;
+        unindexTrigger(source);
+        for (auto member = source.members.begin(); member != source.members.end(); ++member)
+            locations[member->second->getId()].group = &target;
+        target.members.merge(source.members);
+        it = groups.erase(it);
+    }
+
+    node.key() = waterMark;
+    target.waterMark = waterMark;
+    indexTrigger(target);
+    groups.insert(std::move(node));
+}
+
+void TrailingStopIndex::indexTrigger(const Group &group)
+{
+    triggers.emplace(group.waterMark - group.members.begin()->first, group.waterMark);
+}
+
+void TrailingStopIndex::unindexTrigger(const Group &group)
+{
+    triggers.erase({group.waterMark - group.members.begin()->first, group.waterMark});
+}
+
+void TrailingStopIndex::syncBestPrice(const Group &group, Order &order) const
+{
+    order.setBestPrice(denormalize(group.waterMark));
+}
@@ -0,0 +1,319 @@
+#include "database/Journal.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    // Segment header: magic, then the format version of the records that follow.
+    constexpr char MAGIC[7] = {'M', 'I', 'D', 'A', 'S', 'J', 'N'};
+    constexpr uint8_t FORMAT_VERSION = 2;
+    constexpr size_t SEGMENT_HEADER_SIZE = sizeof(MAGIC) + 1;
+
+    // Payload length, CRC of type and payload, type.
+    constexpr size_t RECORD_HEADER_SIZE = 4 + 4 + 1;
+
+    constexpr std::array<uint32_t, 256> makeCrcTable()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    constexpr auto CRC_TABLE = makeCrcTable();
+
+    uint32_t crc32(uint8_t type, std::string_view payload)
+    {
+        uint32_t crc = 0xFFFFFFFFu;
+        crc = CRC_TABLE[(crc ^ type) & 0xFF] ^ (crc >> 8);
+        for (unsigned char byte : payload)
+            crc = CRC_TABLE[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    std::runtime_error systemError(const std::string &action, const std::string &path)
+    {
+        return std::runtime_error("Failed to " + action + " " + path + ": " + std::strerror(errno));
+    }
+
+    std::byte *mapFile(int fd, size_t size, int protection, const std::string &path)
+    {
+        void *mapped = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED)
+            throw systemError("map", path);
+        return static_cast<std::byte *>(mapped);
+    }
+
+    void syncDirectory(const std::string &directory)
+    {
+        int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dirFd < 0)
+            throw systemError("open journal directory", directory);
+        int result = fsync(dirFd);
+        ::close(dirFd);
+        if (result != 0)
+            throw systemError("sync journal directory", directory);
+    }
+
+    void checkHeader(const std::byte *data, size_t size, const std::string &path)
+    {
+        if (size < SEGMENT_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error("Not a journal segment: " + path);
+        auto version = static_cast<unsigned>(data[sizeof(MAGIC)]);
+        if (version != FORMAT_VERSION)
+            throw std::runtime_error("Unsupported journal format version " + std::to_string(version) + ": " + path);
+    }
+}
+
+Journal::Journal(const std::string &directory, size_t segmentSize, JournalPosition recoverFrom)
+    : directory(directory),
+      segmentSize(segmentSize)
+{
+    if (segmentSize < SEGMENT_HEADER_SIZE + RECORD_HEADER_SIZE)
+        throw std::invalid_argument("Journal segment size is too small");
+
+    std::filesystem::create_directories(directory);
+
+    size_t last = 0;
+    while (std::filesystem::exists(segmentPath(last + 1)))
+        ++last;
+
+    if (last == 0)
+    {
+        openSegment(1, true);
+        return;
+    }
+
+    if (recoverFrom.segment > last)
+        throw std::runtime_error("Journal in " + directory + " ends before segment " + std::to_string(recoverFrom.segment));
+
+    openSegment(last, false);
+    size_t start = (recoverFrom.segment == last && recoverFrom.offset > 0) ? recoverFrom.offset : SEGMENT_HEADER_SIZE;
+    if (start > size)
+        throw std::runtime_error("Journal segment " + segmentPath(last) + " is shorter than expected");
+    bool clean = true;
+    offset = scanSegment(data, size, start, nullptr, clean);
+    if (!clean)
+    {
+        // Clear the torn tail so a later scan cannot mistake leftover bytes for records.
+        std::memset(data + offset, 0, size - offset);
+        msync(data, size, MS_SYNC);
+    }
+    syncedOffset = offset;
+}
+
+Journal::~Journal()
+{
+    closeSegment();
+}
+
+std::string Journal::segmentPath(size_t index) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "journal-%06zu.log", index);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+void Journal::openSegment(size_t index, bool create)
+{
+    std::string path = segmentPath(index);
+    if (create)
+    {
+        // The segment is built under a temporary name and renamed into place once its header is on disk, so
+        // a crash never leaves a newest segment without a header for the next open to refuse.
+        std::string tempPath = path + ".tmp";
+        fd = ::open(tempPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            throw systemError("open journal segment", tempPath);
+        if (ftruncate(fd, static_cast<off_t>(segmentSize)) != 0)
+            throw systemError("size journal segment", tempPath);
+
+        std::array<char, SEGMENT_HEADER_SIZE> header{};
+        std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+        header[sizeof(MAGIC)] = static_cast<char>(FORMAT_VERSION);
+        if (pwrite(fd, header.data(), header.size(), 0) != static_cast<ssize_t>(header.size()) || fsync(fd) != 0)
+            throw systemError("write journal segment header", tempPath);
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+            throw systemError("rename journal segment", tempPath);
+        syncDirectory(directory);
+        size = segmentSize;
+    }
+    else
+    {
+        fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0)
+            throw systemError("open journal segment", path);
+
+        struct stat status;
+        if (fstat(fd, &status) != 0)
+            throw systemError("stat journal segment", path);
+        size = static_cast<size_t>(status.st_size);
+    }
+
+    data = mapFile(fd, size, PROT_READ | PROT_WRITE, path);
+    segment = index;
+
+    if (create)
+    {
+        offset = SEGMENT_HEADER_SIZE;
+        syncedOffset = SEGMENT_HEADER_SIZE;
+    }
+    else
+        checkHeader(data, size, path);
+}
+
+void Journal::closeSegment()
+{
+    if (data)
+        munmap(data, size);
+    if (fd >= 0)
+        ::close(fd);
+    data = nullptr;
+    fd = -1;
+}
+
+void Journal::append(uint8_t type, std::string_view payload)
+{
+    size_t recordSize = RECORD_HEADER_SIZE + payload.size();
+    if (recordSize > segmentSize - SEGMENT_HEADER_SIZE)
+        throw std::invalid_argument("Journal record of " + std::to_string(payload.size()) + " bytes does not fit in a segment");
+
+    if (offset + recordSize > size)
+    {
+        sync();
+        closeSegment();
+        openSegment(segment + 1, true);
+    }
+
+    auto length = static_cast<uint32_t>(payload.size());
+    uint32_t crc = crc32(type, payload);
+    std::byte *record = data + offset;
+    std::memcpy(record, &length, 4);
+    std::memcpy(record + 4, &crc, 4);
+    std::memcpy(record + 8, &type, 1);
+    std::memcpy(record + RECORD_HEADER_SIZE, payload.data(), payload.size());
+    offset += recordSize;
+}
+
+void Journal::sync()
+{
+    if (offset == syncedOffset)
+        return;
+
+    // msync needs a page-aligned start.
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = syncedOffset / pageSize * pageSize;
+    if (msync(data + start, offset - start, MS_SYNC) != 0)
+        throw systemError("sync", segmentPath(segment));
+    syncedOffset = offset;
+}
+
+void Journal::replay(const std::function<void(uint8_t type, std::string_view payload)> &visit,
+                     JournalPosition from) const
+{
+    for (size_t index = from.segment; index <= segment; ++index)
+    {
+        size_t start = (index == from.segment && from.offset > 0) ? from.offset : SEGMENT_HEADER_SIZE;
+        replaySegment(index, start, visit);
+    }
+}
+
+void Journal::replaySegment(size_t index, const std::function<void(uint8_t type, std::string_view payload)> &visit) const
+{
+    replaySegment(index, SEGMENT_HEADER_SIZE, visit);
+}
+
+void Journal::replaySegment(size_t index, size_t start,
+                            const std::function<void(uint8_t type, std::string_view payload)> &visit) const
+{
+    bool clean = true;
+    if (index == segment)
+    {
+        scanSegment(data, size, start, &visit, clean);
+        return;
+    }
+
+    std::string path = segmentPath(index);
+    int segmentFd = ::open(path.c_str(), O_RDONLY);
+    if (segmentFd < 0)
+        throw systemError("open journal segment", path);
+    struct stat status;
+    if (fstat(segmentFd, &status) != 0)
+    {
+        ::close(segmentFd);
+        throw systemError("stat journal segment", path);
+    }
+
+    auto segmentBytes = static_cast<size_t>(status.st_size);
+    std::byte *segmentData = nullptr;
+    try
+    {
+        segmentData = mapFile(segmentFd, segmentBytes, PROT_READ, path);
+        checkHeader(segmentData, segmentBytes, path);
+        scanSegment(segmentData, segmentBytes, start, &visit, clean);
+    }
+    catch (...)
+    {
+        if (segmentData)
+            munmap(segmentData, segmentBytes);
+        ::close(segmentFd);
+        throw;
+    }
+    munmap(segmentData, segmentBytes);
+    ::close(segmentFd);
+
+    if (!clean)
+        throw std::runtime_error("Corrupt record in journal segment " + path);
+}
+
+size_t Journal::scanSegment(const std::byte *segmentData, size_t segmentBytes, size_t start,
+                            const std::function<void(uint8_t, std::string_view)> *visit, bool &clean) const
+{
+    size_t position = start;
+    clean = true;
+    while (position + RECORD_HEADER_SIZE <= segmentBytes)
+    {
+        uint32_t length;
+        uint32_t crc;
+        uint8_t type;
+        std::memcpy(&length, segmentData + position, 4);
+        std::memcpy(&crc, segmentData + position + 4, 4);
+        std::memcpy(&type, segmentData + position + 8, 1);
+
+        if (length == 0 && crc == 0 && type == 0)
+            break;
+
+        if (length > segmentBytes - position - RECORD_HEADER_SIZE)
+        {
+            clean = false;
+            break;
+        }
+
+        std::string_view payload(reinterpret_cast<const char *>(segmentData + position + RECORD_HEADER_SIZE), length);
+        if (crc32(type, payload) != crc)
+        {
+            clean = false;
+            break;
+        }
+
+        if (visit)
+            (*visit)(type, payload);
+        position += RECORD_HEADER_SIZE + length;
+    }
+    return position;
+}
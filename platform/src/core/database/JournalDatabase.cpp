@@ -0,0 +1,561 @@
+#include "database/JournalDatabase.hpp"
+#include "BinaryCodec.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace
+{
+    bool isOpen(const Order &order)
+    {
+        return order.getStatus() == OrderStatus::UNFILLED || order.getStatus() == OrderStatus::PARTIALLY_FILLED;
+    }
+
+    bool isConditional(const Order &order)
+    {
+        return order.getType() == OrderType::STOP ||
+               order.getType() == OrderType::STOP_LIMIT ||
+               order.getType() == OrderType::TRAILING_STOP;
+    }
+
+    class JournalOrderRepository : public OrderRepository
+    {
+    public:
+        explicit JournalOrderRepository(std::shared_ptr<JournalStore> store)
+            : store(std::move(store)) {}
+
+        void insert(const Order &order) override { store->writeOrder(order); }
+        void update(const Order &order) override { store->writeOrder(order); }
+        int getLastId() override { return store->getLastOrderId(); }
+
+        std::vector<std::shared_ptr<Order>> getAllActive() override
+        {
+            std::vector<std::shared_ptr<Order>> orders;
+            for (const auto &[id, order] : store->getOpenOrders())
+            {
+                if (!isConditional(order))
+                    orders.push_back(std::make_shared<Order>(order));
+            }
+            return orders;
+        }
+
+        void forEachActiveConditional(const std::function<void(std::shared_ptr<Order>)> &visit) override
+        {
+            for (const auto &[id, order] : store->getOpenOrders())
+            {
+                if (isConditional(order) && order.getStatus() == OrderStatus::UNFILLED)
+                    visit(std::make_shared<Order>(order));
+            }
+        }
+
+    private:
+        std::shared_ptr<JournalStore> store;
+    };
+
+    class JournalTradeRepository : public TradeRepository
+    {
+    public:
+        explicit JournalTradeRepository(std::shared_ptr<JournalStore> store)
+            : store(std::move(store)) {}
+
+        void insert(const Trade &trade) override { store->writeTrade(trade); }
+        int getLastId() override { return store->getLastTradeId(); }
+        std::vector<Trade> getAll() override { return store->readTrades(); }
+        TradeTotals getTotals() override { return store->getTradeTotals(); }
+        std::vector<Trade> getPage(int beforeId, int limit) override { return store->getTradePage(beforeId, limit); }
+        std::vector<Trade> getSince(int afterId) override { return store->getTradesSince(afterId); }
+
+    private:
+        std::shared_ptr<JournalStore> store;
+    };
+
+    class JournalTraderRepository : public TraderRepository
+    {
+    public:
+        explicit JournalTraderRepository(std::shared_ptr<JournalStore> store)
+            : store(std::move(store)) {}
+
+        void save(const TraderState &state) override { store->writeTrader(state); }
+
+        std::vector<TraderState> getAll() override
+        {
+            std::vector<TraderState> states;
+            for (const auto &[traderId, state] : store->getTraders())
+                states.push_back(state);
+            return states;
+        }
+
+    private:
+        std::shared_ptr<JournalStore> store;
+    };
+
+    constexpr uint64_t CHECKPOINT_MAGIC = 0x3150434a5341444dULL; // "MDASJCP1"
+    constexpr uint32_t CHECKPOINT_VERSION = 2;
+}
+
+JournalStore::JournalStore(const std::string &directory, bool syncOnCommit, size_t segmentSize)
+    : checkpointPath((std::filesystem::path(directory) / "checkpoint.bin").string()),
+      journal(directory, segmentSize, readCheckpointPosition(checkpointPath)),
+      syncOnCommit(syncOnCommit)
+{
+    JournalPosition position = loadCheckpoint();
+    journal.replay([this](uint8_t type, std::string_view payload)
+                   { apply(type, payload); },
+                   position);
+}
+
+JournalPosition JournalStore::readCheckpointPosition(const std::string &path)
+{
+    JournalPosition position;
+    auto contents = readFile(path);
+    if (!contents)
+        return position;
+
+    Decoder decoder(*contents);
+    if (decoder.get<uint64_t>() != CHECKPOINT_MAGIC)
+        throw std::runtime_error("Not a journal checkpoint: " + path);
+    auto version = decoder.get<uint32_t>();
+    if (version != CHECKPOINT_VERSION)
+        throw std::runtime_error("Unsupported journal checkpoint version " + std::to_string(version) + ": " + path);
+    position.segment = decoder.get<uint64_t>();
+    position.offset = decoder.get<uint64_t>();
+    return position;
+}
+
+JournalPosition JournalStore::loadCheckpoint()
+{
+    JournalPosition position;
+    auto contents = readFile(checkpointPath);
+    if (!contents)
+        return position;
+
+    Decoder decoder(*contents);
+    // The magic and version were checked by readCheckpointPosition when the journal was opened.
+    decoder.get<uint64_t>();
+    decoder.get<uint32_t>();
+    position.segment = decoder.get<uint64_t>();
+    position.offset = decoder.get<uint64_t>();
+
+    lastOrderId = decoder.get<int>();
+    lastTradeId = decoder.get<int>();
+    tradeTotals = decoder.get<TradeTotals>();
+
+    auto orderCount = decoder.get<uint64_t>();
+    for (uint64_t i = 0; i < orderCount; ++i)
+    {
+        auto order = decodeOrder(decoder.getString());
+        openOrders.insert_or_assign(order.getId(), order);
+    }
+
+    auto tradeCount = decoder.get<uint64_t>();
+    for (uint64_t i = 0; i < tradeCount; ++i)
+        recentTrades.push_back(decodeTrade(decoder.getString()));
+
+    auto traderCount = decoder.get<uint64_t>();
+    for (uint64_t i = 0; i < traderCount; ++i)
+    {
+        auto state = decodeTrader(decoder.getString());
+        traders.insert_or_assign(state.traderId, std::move(state));
+    }
+    return position;
+}
+
+void JournalStore::checkpoint()
+{
+    if (inTransaction)
+        throw std::runtime_error("Failed to checkpoint: a transaction is open");
+
+    // The journal must be on disk up to the checkpoint's position; otherwise a crash could leave later
+    // appends starting before it, and the next open would skip them.
+    journal.sync();
+    auto position = journal.getPosition();
+
+    Encoder encoder;
+    encoder.put(CHECKPOINT_MAGIC)
+        .put(CHECKPOINT_VERSION)
+        .put(static_cast<uint64_t>(position.segment))
+        .put(static_cast<uint64_t>(position.offset))
+        .put(lastOrderId)
+        .put(lastTradeId)
+        .put(tradeTotals)
+        .put(static_cast<uint64_t>(openOrders.size()));
+    for (const auto &[id, order] : openOrders)
+        encoder.putString(encodeOrder(order));
+    encoder.put(static_cast<uint64_t>(recentTrades.size()));
+    for (const auto &trade : recentTrades)
+        encoder.putString(encodeTrade(trade));
+    encoder.put(static_cast<uint64_t>(traders.size()));
+    for (const auto &[traderId, state] : traders)
+        encoder.putString(encodeTrader(state));
+
+    writeFileAtomically(checkpointPath, encoder.take());
+}
+
+std::string JournalStore::encodeOrder(const Order &order)
+{
+    return Encoder()
+        .put(order.getId())
+        .put(order.getType())
+        .put(order.getSide())
+        .put(order.getStatus())
+        .put(order.getInitialQuantity())
+        .put(order.getRemainingQuantity())
+        .put(order.getPrice().getTicks())
+        .put(order.getLimitPrice().getTicks())
+        .put(order.getBestPrice().getTicks())
+        .put(order.getDisplaySize())
+        .put(order.getHiddenQuantity())
+        .put(order.getTimestamp())
+        .putString(order.getTraderId())
+        .take();
+}
+
+Order JournalStore::decodeOrder(std::string_view payload)
+{
+    Decoder decoder(payload);
+    auto id = decoder.get<int>();
+    auto type = decoder.get<OrderType>();
+    auto side = decoder.get<OrderSide>();
+    auto status = decoder.get<OrderStatus>();
+    auto initialQuantity = decoder.get<int>();
+    auto remainingQuantity = decoder.get<int>();
+    auto price = Price::fromTicks(decoder.get<int64_t>());
+    auto limitPrice = Price::fromTicks(decoder.get<int64_t>());
+    auto bestPrice = Price::fromTicks(decoder.get<int64_t>());
+    auto displaySize = decoder.get<int>();
+    auto hiddenQuantity = decoder.get<int>();
+    auto timestamp = decoder.get<long long>();
+    std::string traderId(decoder.getString());
+
+    Order order(type, side, initialQuantity, traderId, price, displaySize, hiddenQuantity, limitPrice, bestPrice);
+    order.setId(id);
+    order.setStatus(status);
+    order.setRemainingQuantity(remainingQuantity);
+    order.setTimestamp(timestamp);
+    return order;
+}
+
+std::string JournalStore::encodeTrade(const Trade &trade)
+{
+    return Encoder()
+        .put(trade.getId())
+        .put(trade.getBuyOrderId())
+        .put(trade.getSellOrderId())
+        .put(trade.getBuyOrderType())
+        .put(trade.getSellOrderType())
+        .put(trade.getQuantity())
+        .put(trade.getPrice().getTicks())
+        .put(trade.getTimestamp())
+        .putString(trade.hasTraders() ? trade.getBuyTraderId() : "")
+        .putString(trade.hasTraders() ? trade.getSellTraderId() : "")
+        .take();
+}
+
+Trade JournalStore::decodeTrade(std::string_view payload)
+{
+    Decoder decoder(payload);
+    auto id = decoder.get<int>();
+    auto buyOrderId = decoder.get<int>();
+    auto sellOrderId = decoder.get<int>();
+    auto buyOrderType = decoder.get<OrderType>();
+    auto sellOrderType = decoder.get<OrderType>();
+    auto quantity = decoder.get<int>();
+    auto price = Price::fromTicks(decoder.get<int64_t>());
+    auto timestamp = decoder.get<long long>();
+    std::string buyTraderId(decoder.getString());
+    std::string sellTraderId(decoder.getString());
+
+    Trade trade(buyOrderId, sellOrderId, buyOrderType, sellOrderType, quantity, price);
+    trade.setId(id);
+    trade.setTimestamp(timestamp);
+    if (!buyTraderId.empty() && !sellTraderId.empty())
+        trade.setTraders(TraderIds::intern(buyTraderId), TraderIds::intern(sellTraderId));
+    return trade;
+}
+
+std::string JournalStore::encodeTrader(const TraderState &state)
+{
+    Encoder encoder;
+    encoder.putString(state.traderId)
+        .putString(state.traderName)
+        .put(static_cast<uint64_t>(state.lots.size()));
+    for (const auto &lot : state.lots)
+        encoder.put(lot.quantity).put(lot.price);
+    encoder.put(state.reservedInventory)
+        .put(state.totalClosedTrades)
+        .put(state.avgExitPrice)
+        .put(state.wins)
+        .put(state.openPosition)
+        .put(state.realizedPnL)
+        .put(state.peakValue)
+        .put(state.troughValue)
+        .put(state.maxDrawdown);
+    return encoder.take();
+}
+
+TraderState JournalStore::decodeTrader(std::string_view payload)
+{
+    Decoder decoder(payload);
+    TraderState state;
+    state.traderId = decoder.getString();
+    state.traderName = decoder.getString();
+    auto lotCount = decoder.get<uint64_t>();
+    for (uint64_t i = 0; i < lotCount; ++i)
+    {
+        int quantity = decoder.get<int>();
+        double price = decoder.get<double>();
+        state.lots.push_back({quantity, price});
+    }
+    state.reservedInventory = decoder.get<int>();
+    state.totalClosedTrades = decoder.get<int>();
+    state.avgExitPrice = decoder.get<double>();
+    state.wins = decoder.get<int>();
+    state.openPosition = decoder.get<int>();
+    state.realizedPnL = decoder.get<double>();
+    state.peakValue = decoder.get<double>();
+    state.troughValue = decoder.get<double>();
+    state.maxDrawdown = decoder.get<double>();
+    return state;
+}
+
+void JournalStore::writeOrder(const Order &order)
+{
+    write(ORDER, encodeOrder(order));
+}
+
+void JournalStore::writeTrade(const Trade &trade)
+{
+    write(TRADE, encodeTrade(trade));
+}
+
+void JournalStore::writeTrader(const TraderState &state)
+{
+    write(TRADER, encodeTrader(state));
+}
+
+void JournalStore::write(RecordType type, std::string payload)
+{
+    if (inTransaction)
+    {
+        pending.emplace_back(type, std::move(payload));
+        return;
+    }
+
+    journal.append(type, payload);
+    if (syncOnCommit)
+        journal.sync();
+    apply(type, payload);
+}
+
+void JournalStore::begin()
+{
+    if (inTransaction)
+        throw std::runtime_error("Failed to begin transaction: a transaction is already open");
+    inTransaction = true;
+}
+
+void JournalStore::commit()
+{
+    if (!inTransaction)
+        throw std::runtime_error("Failed to commit transaction: no transaction is open");
+    inTransaction = false;
+
+    if (pending.empty())
+        return;
+
+    Encoder batch;
+    for (const auto &[type, payload] : pending)
+        batch.put(static_cast<uint8_t>(type)).putString(payload);
+    std::string payload = batch.take();
+
+    try
+    {
+        journal.append(BATCH, payload);
+        if (syncOnCommit)
+            journal.sync();
+    }
+    catch (...)
+    {
+        pending.clear();
+        throw;
+    }
+
+    pending.clear();
+    apply(BATCH, payload);
+}
+
+void JournalStore::rollback()
+{
+    inTransaction = false;
+    pending.clear();
+}
+
+void JournalStore::apply(uint8_t type, std::string_view payload)
+{
+    switch (type)
+    {
+    case ORDER:
+        applyOrder(decodeOrder(payload));
+        break;
+    case TRADE:
+        applyTrade(decodeTrade(payload));
+        break;
+    case TRADER:
+    {
+        auto state = decodeTrader(payload);
+        traders.insert_or_assign(state.traderId, std::move(state));
+        break;
+    }
+    case BATCH:
+    {
+        Decoder decoder(payload);
+        while (!decoder.done())
+        {
+            auto nestedType = decoder.get<uint8_t>();
+            apply(nestedType, decoder.getString());
+        }
+        break;
+    }
+    default:
+        throw std::runtime_error("Unknown journal record type " + std::to_string(type));
+    }
+}
+
+void JournalStore::applyOrder(const Order &order)
+{
+    lastOrderId = std::max(lastOrderId, order.getId());
+    if (isOpen(order))
+        openOrders.insert_or_assign(order.getId(), order);
+    else
+        openOrders.erase(order.getId());
+}
+
+void JournalStore::applyTrade(const Trade &trade)
+{
+    lastTradeId = std::max(lastTradeId, trade.getId());
+    ++tradeTotals.count;
+    tradeTotals.volume += trade.getQuantity();
+    tradeTotals.notional += trade.getQuantity() * trade.getPrice().toDouble();
+
+    recentTrades.push_back(trade);
+    if (recentTrades.size() > RECENT_TRADES)
+        recentTrades.pop_front();
+}
+
+void JournalStore::collectTrades(uint8_t type, std::string_view payload, std::vector<Trade> &trades)
+{
+    if (type == TRADE)
+        trades.push_back(decodeTrade(payload));
+    else if (type == BATCH)
+    {
+        Decoder decoder(payload);
+        while (!decoder.done())
+        {
+            auto nestedType = decoder.get<uint8_t>();
+            collectTrades(nestedType, decoder.getString(), trades);
+        }
+    }
+}
+
+std::vector<Trade> JournalStore::readTrades() const
+{
+    std::vector<Trade> trades;
+    journal.replay([&trades](uint8_t type, std::string_view payload)
+                   { collectTrades(type, payload, trades); });
+    return trades;
+}
+
+std::vector<Trade> JournalStore::getTradePage(int beforeId, int limit) const
+{
+    std::vector<Trade> page;
+    for (auto it = recentTrades.rbegin(); it != recentTrades.rend() && static_cast<int>(page.size()) < limit; ++it)
+    {
+        if (it->getId() < beforeId)
+            page.push_back(*it);
+    }
+
+    bool olderInJournal = static_cast<size_t>(tradeTotals.count) > recentTrades.size();
+    if (static_cast<int>(page.size()) == limit || !olderInJournal)
+        return page;
+
+    // Trades are appended in id order, so the segments are read newest first until the page is full, and a
+    // segment whose first trade is not before the cursor is skipped without being read.
+    page.clear();
+    std::vector<Trade> trades;
+    for (size_t index = journal.getSegmentCount(); index > 0 && static_cast<int>(page.size()) < limit; --index)
+    {
+        auto first = firstTradeIds.find(index);
+        if (first != firstTradeIds.end() && (first->second == 0 || first->second >= beforeId))
+            continue;
+
+        readSegmentTrades(index, trades);
+        for (auto it = trades.rbegin(); it != trades.rend() && static_cast<int>(page.size()) < limit; ++it)
+        {
+            if (it->getId() < beforeId)
+                page.push_back(*it);
+        }
+    }
+    return page;
+}
+
+std::vector<Trade> JournalStore::getTradesSince(int afterId) const
+{
+    bool covered = static_cast<size_t>(tradeTotals.count) == recentTrades.size() ||
+                   (!recentTrades.empty() && recentTrades.front().getId() <= afterId + 1);
+    std::vector<Trade> trades;
+    if (covered)
+    {
+        for (const auto &trade : recentTrades)
+        {
+            if (trade.getId() > afterId)
+                trades.push_back(trade);
+        }
+        return trades;
+    }
+
+    // Ids only grow, so once a segment starts at or before the trade after `afterId`, the segments before it
+    // hold nothing newer and are never read.
+    std::vector<std::vector<Trade>> segments;
+    for (size_t index = journal.getSegmentCount(); index > 0; --index)
+    {
+        auto first = firstTradeIds.find(index);
+        if (first != firstTradeIds.end() && first->second == 0)
+            continue;
+
+        readSegmentTrades(index, segments.emplace_back());
+        const auto &segmentTrades = segments.back();
+        if (!segmentTrades.empty() && segmentTrades.front().getId() <= afterId + 1)
+            break;
+    }
+
+    for (auto segment = segments.rbegin(); segment != segments.rend(); ++segment)
+    {
+        for (auto &trade : *segment)
+        {
+            if (trade.getId() > afterId)
+                trades.push_back(std::move(trade));
+        }
+    }
+    return trades;
+}
+
+void JournalStore::readSegmentTrades(size_t index, std::vector<Trade> &trades) const
+{
+    trades.clear();
+    journal.replaySegment(index, [&trades](uint8_t type, std::string_view payload)
+                          { collectTrades(type, payload, trades); });
+    // Only the newest segment is still being appended to; once it holds a trade, its first trade is fixed.
+    if (!trades.empty())
+        firstTradeIds[index] = trades.front().getId();
+    else if (index < journal.getSegmentCount())
+        firstTradeIds[index] = 0;
+}
+
+JournalDatabase::JournalDatabase(const std::string &directory, StorageOptions options, size_t segmentSize)
+    : store(std::make_shared<JournalStore>(directory, options.synchronous != SyncMode::OFF, segmentSize)),
+      ordersRepo(std::make_shared<JournalOrderRepository>(store)),
+      tradesRepo(std::make_shared<JournalTradeRepository>(store)),
+      tradersRepo(std::make_shared<JournalTraderRepository>(store))
+{
+}
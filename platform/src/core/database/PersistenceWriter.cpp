@@ -0,0 +1,236 @@
+#include "database/PersistenceWriter.hpp"
+
+#include <iostream>
+#include <mutex>
+
+PersistenceWriter::PersistenceWriter(std::shared_ptr<Database> database, PersistenceOptions options)
+    : database(database),
+      options(options),
+      queue(options.queueCapacity),
+      storedTradeId(database->trades()->getLastId()),
+      writer(&PersistenceWriter::run, this)
+{
+}
+
+PersistenceWriter::~PersistenceWriter()
+{
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+}
+
+void PersistenceWriter::insertOrder(const Order &order)
+{
+    enqueue(OrderInsert{order});
+}
+
+void PersistenceWriter::updateOrder(const Order &order)
+{
+    enqueue(OrderUpdate{order});
+}
+
+void PersistenceWriter::insertTrade(const Trade &trade)
+{
+    enqueue(TradeInsert{trade});
+}
+
+void PersistenceWriter::updateTrader(const TraderState &state)
+{
+    enqueue(TraderUpdate{state});
+}
+
+void PersistenceWriter::beginBatch()
+{
+    enqueue(BatchBegin{});
+}
+
+void PersistenceWriter::endBatch()
+{
+    enqueue(BatchEnd{});
+}
+
+void PersistenceWriter::enqueue(PersistenceRecord record)
+{
+    // A full queue means the writer is behind; wait for it rather than drop or reorder changes.
+    while (!queue.tryPush(record))
+        std::this_thread::yield();
+    enqueued.fetch_add(1, std::memory_order_release);
+}
+
+void PersistenceWriter::flush()
+{
+    uint64_t target = enqueued.load(std::memory_order_acquire);
+    flushWaiters.fetch_add(1, std::memory_order_acq_rel);
+    for (uint64_t done = committed.load(std::memory_order_acquire); done < target; done = committed.load(std::memory_order_acquire))
+        committed.wait(done, std::memory_order_acquire);
+    flushWaiters.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void PersistenceWriter::sync()
+{
+    if (options.durability == Durability::COMMIT_BEFORE_RETURN)
+        flush();
+}
+
+PersistenceStats PersistenceWriter::getStats() const
+{
+    return PersistenceStats{
+        recordCount.load(std::memory_order_relaxed),
+        batchCount.load(std::memory_order_relaxed),
+        coalescedCount.load(std::memory_order_relaxed),
+        failedCommitCount.load(std::memory_order_relaxed)};
+}
+
+void PersistenceWriter::run()
+{
+    auto batchStart = std::chrono::steady_clock::now();
+    PersistenceRecord record;
+
+    while (true)
+    {
+        // Draining is capped per pass, not by batch size, so the queue keeps moving even while a commit is
+        // held off by another thread's transaction.
+        size_t drained = 0;
+        while (drained < options.maxBatchSize && queue.tryPop(record))
+        {
+            apply(record);
+            ++drained;
+        }
+
+        bool stop = stopping.load(std::memory_order_acquire);
+        bool pending = dequeued > committed.load(std::memory_order_relaxed);
+        if (pending)
+        {
+            // An open batch is held back until its end marker arrives, however long that takes.
+            bool due = stop ||
+                       (openBatches == 0 &&
+                        (pendingOrders.size() + pendingTrades.size() + pendingTraders.size() >= options.maxBatchSize ||
+                         flushWaiters.load(std::memory_order_acquire) > 0 ||
+                         std::chrono::steady_clock::now() - batchStart >= options.flushInterval));
+            if (due && std::chrono::steady_clock::now() >= retryAfter)
+            {
+                CommitResult result = tryCommit();
+                if (result == CommitResult::COMMITTED)
+                {
+                    batchStart = std::chrono::steady_clock::now();
+                    continue;
+                }
+                if (result == CommitResult::FAILED)
+                {
+                    if (stop)
+                    {
+                        std::cerr << "Stopping with " << dequeued - committed.load(std::memory_order_relaxed)
+                                  << " changes that could not be persisted" << std::endl;
+                        return;
+                    }
+                    retryAfter = std::chrono::steady_clock::now() + RETRY_INTERVAL;
+                }
+            }
+        }
+        else
+        {
+            batchStart = std::chrono::steady_clock::now();
+            if (stop && enqueued.load(std::memory_order_acquire) == dequeued)
+                return;
+        }
+
+        // Poll quickly while a batch is open, so flushes are picked up promptly, and back off when idle.
+        if (drained == 0)
+            std::this_thread::sleep_for(pending ? std::chrono::microseconds(100) : std::chrono::microseconds(1000));
+    }
+}
+
+void PersistenceWriter::apply(PersistenceRecord &record)
+{
+    ++dequeued;
+    if (auto *update = std::get_if<OrderUpdate>(&record))
+    {
+        // An order created in this batch is still written with one insert, carrying its latest state.
+        auto [it, added] = pendingOrders.try_emplace(update->order.getId(), PendingOrder{update->order, false});
+        if (!added)
+        {
+            it->second.order = update->order;
+            coalescedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else if (auto *insert = std::get_if<OrderInsert>(&record))
+    {
+        pendingOrders.insert_or_assign(insert->order.getId(), PendingOrder{insert->order, true});
+    }
+    else if (auto *trade = std::get_if<TradeInsert>(&record))
+    {
+        pendingTrades.push_back(trade->trade);
+    }
+    else if (auto *trader = std::get_if<TraderUpdate>(&record))
+    {
+        auto [it, added] = pendingTraders.try_emplace(trader->state.traderId, trader->state);
+        if (!added)
+        {
+            it->second = std::move(trader->state);
+            coalescedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else if (std::holds_alternative<BatchBegin>(record))
+    {
+        ++openBatches;
+    }
+    else if (std::holds_alternative<BatchEnd>(record))
+    {
+        --openBatches;
+    }
+}
+
+// Another thread may hold the connection for a transaction of its own; in that case the writer keeps
+// draining the queue and tries again, so producers never wait on a lock the writer needs. A failed commit
+// is rolled back and its changes stay pending for the next attempt; committed only moves past changes that
+// were written.
+PersistenceWriter::CommitResult PersistenceWriter::tryCommit()
+{
+    std::unique_lock lock(database->getMutex(), std::try_to_lock);
+    if (!lock.owns_lock())
+        return CommitResult::BUSY;
+
+    try
+    {
+        database->beginTransaction();
+        try
+        {
+            for (const auto &[orderId, pending] : pendingOrders)
+            {
+                if (pending.inserted)
+                    database->orders()->insert(pending.order);
+                else
+                    database->orders()->update(pending.order);
+            }
+            for (const auto &trade : pendingTrades)
+                database->trades()->insert(trade);
+            // Written in the same transaction as the trades that moved them, so positions and trades are
+            // always recovered in step.
+            for (const auto &[traderId, state] : pendingTraders)
+                database->traders()->save(state);
+            database->commitTransaction();
+        }
+        catch (...)
+        {
+            database->rollbackTransaction();
+            throw;
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        failedCommitCount.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Failed to persist " << pendingOrders.size() << " orders, " << pendingTrades.size()
+                  << " trades and " << pendingTraders.size() << " traders, will retry: " << ex.what() << std::endl;
+        return CommitResult::FAILED;
+    }
+
+    recordCount.fetch_add(pendingOrders.size() + pendingTrades.size() + pendingTraders.size(), std::memory_order_relaxed);
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+    if (!pendingTrades.empty())
+        storedTradeId.store(pendingTrades.back().getId(), std::memory_order_release);
+    pendingOrders.clear();
+    pendingTrades.clear();
+    pendingTraders.clear();
+    committed.store(dequeued, std::memory_order_release);
+    committed.notify_all();
+    return CommitResult::COMMITTED;
+}
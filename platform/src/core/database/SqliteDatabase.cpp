@@ -0,0 +1,144 @@
+#include "database/SqliteDatabase.hpp"
+#include "database/SqliteOrderRepository.hpp"
+#include "database/SqliteTradeRepository.hpp"
+#include "database/SqliteTraderRepository.hpp"
+
+#include <string>
+#include <stdexcept>
+
+#define CREATE_ORDERS_TABLE_SQL \
+    "CREATE TABLE IF NOT EXISTS orders (" \
+    "id INTEGER PRIMARY KEY, " \
+    "type INTEGER, " \
+    "side INTEGER, " \
+    "status INTEGER, " \
+    "initialQuantity INTEGER, " \
+    "remainingQuantity INTEGER, " \
+    "traderId TEXT, " \
+    "price REAL, " \
+    "limitPrice REAL, " \
+    "bestPrice REAL, " \
+    "displaySize INTEGER, " \
+    "hiddenQuantity INTEGER, " \
+    "timestamp INTEGER" \
+    ");"
+
+#define CREATE_TRADES_TABLE_SQL \
+    "CREATE TABLE IF NOT EXISTS trades (" \
+    "id INTEGER PRIMARY KEY AUTOINCREMENT, " \
+    "buyOrderId INTEGER, " \
+    "sellOrderId INTEGER, " \
+    "quantity INTEGER, " \
+    "price REAL, " \
+    "timestamp INTEGER" \
+    ");"
+
+#define CREATE_TRADERS_TABLE_SQL \
+    "CREATE TABLE IF NOT EXISTS traders (" \
+    "id INTEGER PRIMARY KEY, " \
+    "traderId TEXT UNIQUE NOT NULL, " \
+    "traderName TEXT, " \
+    "lots BLOB, " \
+    "reservedInventory INTEGER, " \
+    "totalClosedTrades INTEGER, " \
+    "avgExitPrice REAL, " \
+    "wins INTEGER, " \
+    "openPosition INTEGER, " \
+    "realizedPnL REAL, " \
+    "peakValue REAL, " \
+    "troughValue REAL, " \
+    "maxDrawdown REAL" \
+    ");"
+
+#define CREATE_INDEXES_SQL \
+    "CREATE INDEX IF NOT EXISTS idx_orders_status_type ON orders (status, type);" \
+    "CREATE INDEX IF NOT EXISTS idx_orders_trader ON orders (traderId);" \
+    "CREATE INDEX IF NOT EXISTS idx_trades_timestamp ON trades (timestamp);"
+
+SqliteDatabase::SqliteDatabase(const std::string &dbFile, StorageOptions options)
+{
+    if (sqlite3_open(dbFile.c_str(), &db))
+    {
+        throw std::runtime_error("Failed to open database");
+    }
+    configure(options);
+
+    char *errMsg = nullptr;
+    int rc = sqlite3_exec(db, CREATE_ORDERS_TABLE_SQL, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK)
+    {
+        std::string error = errMsg;
+        sqlite3_free(errMsg);
+        throw std::runtime_error("Failed to create orders table: " + error);
+    }
+
+    rc = sqlite3_exec(db, CREATE_TRADES_TABLE_SQL, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK)
+    {
+        std::string error = errMsg;
+        sqlite3_free(errMsg);
+        throw std::runtime_error("Failed to create trades table: " + error);
+    }
+
+    execute(CREATE_TRADERS_TABLE_SQL, "create traders table");
+
+    if (options.indexes)
+        execute(CREATE_INDEXES_SQL, "create indexes");
+
+    ordersRepo = std::make_shared<SqliteOrderRepository>(db);
+    tradesRepo = std::make_shared<SqliteTradeRepository>(db);
+    tradersRepo = std::make_shared<SqliteTraderRepository>(db);
+}
+
+void SqliteDatabase::execute(const char *sql, const std::string &action)
+{
+    char *errMsg = nullptr;
+    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK)
+    {
+        std::string error = errMsg ? errMsg : sqlite3_errmsg(db);
+        sqlite3_free(errMsg);
+        throw std::runtime_error("Failed to " + action + ": " + error);
+    }
+}
+
+void SqliteDatabase::configure(const StorageOptions &options)
+{
+    // An in-memory database reports journal_mode=memory whatever is asked for, so the result is not checked.
+    if (options.journalMode == JournalMode::WAL)
+        execute("PRAGMA journal_mode=WAL;", "enable WAL");
+
+    switch (options.synchronous)
+    {
+    case SyncMode::FULL:
+        execute("PRAGMA synchronous=FULL;", "set synchronous mode");
+        break;
+    case SyncMode::NORMAL:
+        execute("PRAGMA synchronous=NORMAL;", "set synchronous mode");
+        break;
+    case SyncMode::OFF:
+        execute("PRAGMA synchronous=OFF;", "set synchronous mode");
+        break;
+    }
+
+    if (options.mmapSize > 0)
+        execute(("PRAGMA mmap_size=" + std::to_string(options.mmapSize) + ";").c_str(), "set mmap size");
+    // A negative cache_size is a size in KiB rather than a page count.
+    if (options.cacheSize > 0)
+        execute(("PRAGMA cache_size=-" + std::to_string(options.cacheSize / 1024) + ";").c_str(), "set cache size");
+}
+
+void SqliteDatabase::beginTransaction()
+{
+    execute("BEGIN TRANSACTION;", "begin transaction");
+}
+
+void SqliteDatabase::commitTransaction()
+{
+    execute("COMMIT;", "commit transaction");
+}
+
+void SqliteDatabase::rollbackTransaction()
+{
+    execute("ROLLBACK;", "roll back transaction");
+}
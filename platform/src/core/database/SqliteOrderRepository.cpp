@@ -1,20 +1,22 @@
-#include "database/OrderRepository.hpp"
+#include "database/SqliteOrderRepository.hpp"
 
-int OrderRepository::create(const Order &order)
+void SqliteOrderRepository::insert(const Order &order)
 {
-    OrderRecord record = OrderRecord::fromOrder(order);
-    int newId = this->createRecord(record);
-    record.setId(newId);
-    return newId;
+    this->insertRecord(OrderRecord::fromOrder(order));
 }
 
-void OrderRepository::update(const Order &order)
+int SqliteOrderRepository::getLastId()
+{
+    return this->getLastRecordId();
+}
+
+void SqliteOrderRepository::update(const Order &order)
 {
     OrderRecord record = OrderRecord::fromOrder(order);
     this->updateRecord(record);
 }
 
-std::vector<std::shared_ptr<Order>> OrderRepository::getAllActive()
+std::vector<std::shared_ptr<Order>> SqliteOrderRepository::getAllActive()
 {
     std::string whereClause = "status IN (" +
                               std::to_string(static_cast<int>(OrderStatus::UNFILLED)) + ", " +
@@ -32,4 +34,16 @@ std::vector<std::shared_ptr<Order>> OrderRepository::getAllActive()
         orders.push_back(record.toOrder());
 
     return orders;
-}
\ No newline at end of file
+}
+
+void SqliteOrderRepository::forEachActiveConditional(const std::function<void(std::shared_ptr<Order>)> &visit)
+{
+    std::string whereClause = "status = " + std::to_string(static_cast<int>(OrderStatus::UNFILLED)) +
+                              " AND type IN (" +
+                              std::to_string(static_cast<int>(OrderType::STOP)) + ", " +
+                              std::to_string(static_cast<int>(OrderType::STOP_LIMIT)) + ", " +
+                              std::to_string(static_cast<int>(OrderType::TRAILING_STOP)) + ")";
+
+    this->forEachRecord(whereClause, [&visit](const OrderRecord &record)
+                        { visit(record.toOrder()); });
+}
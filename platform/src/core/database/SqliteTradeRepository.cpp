@@ -0,0 +1,59 @@
+#include "database/SqliteTradeRepository.hpp"
+
+void SqliteTradeRepository::insert(const Trade &trade)
+{
+    this->insertRecord(TradeRecord::fromTrade(trade));
+}
+
+int SqliteTradeRepository::getLastId()
+{
+    return this->getLastRecordId();
+}
+
+TradeTotals SqliteTradeRepository::getTotals()
+{
+    const char *sql = "SELECT COUNT(*), COALESCE(SUM(quantity), 0), COALESCE(SUM(quantity * price), 0) FROM trades;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(getConnection(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        throw std::runtime_error("Prepare error in getTotals: " + std::string(sqlite3_errmsg(getConnection())));
+    }
+    TradeTotals totals;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        totals.count = sqlite3_column_int(stmt, 0);
+        totals.volume = sqlite3_column_int64(stmt, 1);
+        totals.notional = sqlite3_column_double(stmt, 2);
+    }
+    sqlite3_finalize(stmt);
+    return totals;
+}
+
+std::vector<Trade> SqliteTradeRepository::getPage(int beforeId, int limit)
+{
+    std::string whereClause = "trades.id < " + std::to_string(beforeId) +
+                              " ORDER BY trades.id DESC LIMIT " + std::to_string(limit);
+    std::vector<Trade> trades;
+    this->forEachRecord(whereClause, [&trades](const TradeRecord &record)
+                        { trades.push_back(*record.toTrade()); });
+    return trades;
+}
+
+std::vector<Trade> SqliteTradeRepository::getSince(int afterId)
+{
+    std::string whereClause = "trades.id > " + std::to_string(afterId) + " ORDER BY trades.id";
+    std::vector<Trade> trades;
+    this->forEachRecord(whereClause, [&trades](const TradeRecord &record)
+                        { trades.push_back(*record.toTrade()); });
+    return trades;
+}
+
+std::vector<Trade> SqliteTradeRepository::getAll()
+{
+    auto records = this->getAllRecords();
+    std::vector<Trade> trades;
+    for (auto &record : records)
+        trades.push_back(*record.toTrade());
+
+    return trades;
+}
\ No newline at end of file
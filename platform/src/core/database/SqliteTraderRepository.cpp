@@ -0,0 +1,14 @@
+#include "database/SqliteTraderRepository.hpp"
+
+void SqliteTraderRepository::save(const TraderState &state)
+{
+    this->upsertRecord(TraderRecord::fromState(state));
+}
+
+std::vector<TraderState> SqliteTraderRepository::getAll()
+{
+    std::vector<TraderState> states;
+    this->forEachRecord("", [&states](const TraderRecord &record)
+                        { states.push_back(record.toState()); });
+    return states;
+}
@@ -16,10 +16,14 @@ const std::vector<std::string> TradeRecord::joins = {
 
 const std::vector<std::string> TradeRecord::joinSelects = {
     "b.type AS buyOrderType",
-    "s.type AS sellOrderType"
+    "s.type AS sellOrderType",
+    "b.traderId AS buyTraderId",
+    "s.traderId AS sellTraderId"
 };
 
 const std::vector<FieldDescriptor<TradeRecord>> TradeRecord::joinFields = {
     INT_FIELD(buyOrderType, getBuyOrderType, setBuyOrderType),
     INT_FIELD(sellOrderType, getSellOrderType, setSellOrderType),
+    TEXT_FIELD(buyTraderId, getBuyTraderId, setBuyTraderId),
+    TEXT_FIELD(sellTraderId, getSellTraderId, setSellTraderId),
 };
@@ -0,0 +1,21 @@
+#include "database/TraderMapping.hpp"
+#include "database-utils.hpp"
+
+const std::vector<FieldDescriptor<TraderRecord>> TraderRecord::fields = {
+    TEXT_FIELD(traderId, getTraderId, setTraderId),
+    TEXT_FIELD(traderName, getTraderName, setTraderName),
+    BLOB_FIELD(lots, getLots, setLots),
+    INT_FIELD(reservedInventory, getReservedInventory, setReservedInventory),
+    INT_FIELD(totalClosedTrades, getTotalClosedTrades, setTotalClosedTrades),
+    DOUBLE_FIELD(avgExitPrice, getAvgExitPrice, setAvgExitPrice),
+    INT_FIELD(wins, getWins, setWins),
+    INT_FIELD(openPosition, getOpenPosition, setOpenPosition),
+    DOUBLE_FIELD(realizedPnL, getRealizedPnL, setRealizedPnL),
+    DOUBLE_FIELD(peakValue, getPeakValue, setPeakValue),
+    DOUBLE_FIELD(troughValue, getTroughValue, setTroughValue),
+    DOUBLE_FIELD(maxDrawdown, getMaxDrawdown, setMaxDrawdown),
+};
+
+const std::vector<std::string> TraderRecord::joins = {};
+const std::vector<std::string> TraderRecord::joinSelects = {};
+const std::vector<FieldDescriptor<TraderRecord>> TraderRecord::joinFields = {};
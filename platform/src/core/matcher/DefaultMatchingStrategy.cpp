@@ -7,7 +7,7 @@
 bool DefaultMatchingStrategy::isPriceAcceptable(const Order &incomingOrder,
                                                 const Order &opposingOrder) const
 {
-    if (incomingOrder.getPrice() > 0 && opposingOrder.getPrice() > 0)
+    if (incomingOrder.getPrice().isSet() && opposingOrder.getPrice().isSet())
     {
         if (incomingOrder.getSide() == OrderSide::BID && incomingOrder.getPrice() < opposingOrder.getPrice())
             return false;
@@ -17,113 +17,215 @@ bool DefaultMatchingStrategy::isPriceAcceptable(const Order &incomingOrder,
     return true;
 }
 
-void DefaultMatchingStrategy::processNormalOrderMatch(std::shared_ptr<Order> opposingOrderPtr,
+void DefaultMatchingStrategy::processNormalOrderMatch(OrderHandle opposingHandle,
+                                                      Order &opposingOrder,
                                                       int matchQty,
                                                       int availableQty,
                                                       OrderQueueManager &orderQueueManager,
-                                                      std::vector<std::shared_ptr<Order>> &updatedOrders) const
+                                                      std::vector<OrderHandle> &updatedOrders) const
 {
-    auto &queue = orderQueueManager.getQueue(opposingOrderPtr->getSide());
-    queue.pop();
     if (matchQty < availableQty)
     {
-        opposingOrderPtr->setRemainingQuantity(availableQty - matchQty);
-        opposingOrderPtr->setStatus(OrderStatus::PARTIALLY_FILLED);
-        queue.push(opposingOrderPtr);
+        orderQueueManager.updateQuantity(opposingHandle, availableQty - matchQty);
+        opposingOrder.setStatus(OrderStatus::PARTIALLY_FILLED);
     }
     else
     {
-        opposingOrderPtr->setStatus(OrderStatus::FILLED);
+        opposingOrder.setStatus(OrderStatus::FILLED);
+        orderQueueManager.dequeueOrder(opposingHandle);
     }
-    updatedOrders.push_back(opposingOrderPtr);
+    updatedOrders.push_back(opposingHandle);
 }
 
-void DefaultMatchingStrategy::processIcebergOrderMatch(std::shared_ptr<Order> opposingOrderPtr,
+void DefaultMatchingStrategy::processIcebergOrderMatch(OrderHandle opposingHandle,
+                                                       Order &opposingOrder,
                                                        int matchQty, int availableQty,
                                                        OrderQueueManager &orderQueueManager,
-                                                       std::vector<std::shared_ptr<Order>> &updatedOrders) const
+                                                       std::vector<OrderHandle> &updatedOrders) const
 {
-    auto &queue = orderQueueManager.getQueue(opposingOrderPtr->getSide());
-    queue.pop();
     if (matchQty == availableQty)
     {
-        int hiddenQty = opposingOrderPtr->getHiddenQuantity();
+        int hiddenQty = opposingOrder.getHiddenQuantity();
         if (hiddenQty > 0)
         {
-            int replenish = std::min(opposingOrderPtr->getDisplaySize(), hiddenQty);
+            int replenish = std::min(opposingOrder.getDisplaySize(), hiddenQty);
 
-            opposingOrderPtr->setHiddenQuantity(hiddenQty - replenish);
-            opposingOrderPtr->setRemainingQuantity(replenish);
-            opposingOrderPtr->setStatus(OrderStatus::PARTIALLY_FILLED);
-
-            queue.push(opposingOrderPtr);
+            opposingOrder.setHiddenQuantity(hiddenQty - replenish);
+            orderQueueManager.updateQuantity(opposingHandle, replenish);
+            opposingOrder.setStatus(OrderStatus::PARTIALLY_FILLED);
         }
         else
         {
-            opposingOrderPtr->setStatus(OrderStatus::FILLED);
+            opposingOrder.setStatus(OrderStatus::FILLED);
+            orderQueueManager.dequeueOrder(opposingHandle);
         }
     }
     else
     {
-        opposingOrderPtr->setRemainingQuantity(availableQty - matchQty);
-        opposingOrderPtr->setStatus(OrderStatus::PARTIALLY_FILLED);
+        orderQueueManager.updateQuantity(opposingHandle, availableQty - matchQty);
+        opposingOrder.setStatus(OrderStatus::PARTIALLY_FILLED);
+    }
+    updatedOrders.push_back(opposingHandle);
+}
 
-        queue.push(opposingOrderPtr);
+bool DefaultMatchingStrategy::preventSelfTrade(Order &incomingOrder,
+                                               int &unmatchedQuantity,
+                                               OrderHandle opposingHandle,
+                                               Order &opposingOrder,
+                                               SelfTradePrevention selfTradePrevention,
+                                               OrderQueueManager &orderQueueManager,
+                                               std::vector<OrderHandle> &updatedOrders) const
+{
+    switch (selfTradePrevention)
+    {
+    case SelfTradePrevention::SKIP:
+        break;
+    case SelfTradePrevention::CANCEL_NEWEST:
+        incomingOrder.setStatus(OrderStatus::CANCELLED);
+        return false;
+    case SelfTradePrevention::CANCEL_OLDEST:
+        opposingOrder.setStatus(OrderStatus::CANCELLED);
+        orderQueueManager.dequeueOrder(opposingHandle);
+        updatedOrders.push_back(opposingHandle);
+        break;
+    case SelfTradePrevention::DECREMENT_BOTH:
+    {
+        // An iceberg is decremented by its whole size, displayed and hidden, not just what is on show.
+        int displayedQty = opposingOrder.getRemainingQuantity();
+        int hiddenQty = (opposingOrder.getType() == OrderType::ICEBERG) ? std::max(0, opposingOrder.getHiddenQuantity()) : 0;
+        int decrement = std::min(unmatchedQuantity, displayedQty + hiddenQty);
+
+        // Nothing traded, so both orders shrink as though they had been entered smaller. Their initial
+        // quantities go down with them, so neither is reported as partially filled.
+        unmatchedQuantity -= decrement;
+        incomingOrder.setInitialQuantity(std::max(0, incomingOrder.getInitialQuantity() - decrement));
+        opposingOrder.setInitialQuantity(std::max(0, opposingOrder.getInitialQuantity() - decrement));
+        if (unmatchedQuantity == 0)
+            incomingOrder.setStatus(OrderStatus::CANCELLED);
+
+        // setInitialQuantity also resets the remaining quantity, so each branch below sets what is left of the
+        // resting order explicitly; it may have been partly filled before.
+        if (decrement == displayedQty + hiddenQty)
+        {
+            opposingOrder.setRemainingQuantity(0);
+            if (opposingOrder.getType() == OrderType::ICEBERG)
+                opposingOrder.setHiddenQuantity(0);
+            opposingOrder.setStatus(OrderStatus::CANCELLED);
+            orderQueueManager.dequeueOrder(opposingHandle);
+        }
+        else if (decrement >= displayedQty)
+        {
+            // The display is used up; show the next slice of what is left hidden, as after a fill.
+            int hiddenLeft = hiddenQty - (decrement - displayedQty);
+            int replenish = std::min(opposingOrder.getDisplaySize(), hiddenLeft);
+            opposingOrder.setHiddenQuantity(hiddenLeft - replenish);
+            orderQueueManager.updateQuantity(opposingHandle, replenish);
+        }
+        else
+        {
+            orderQueueManager.updateQuantity(opposingHandle, displayedQty - decrement);
+        }
+        updatedOrders.push_back(opposingHandle);
+        break;
     }
-    updatedOrders.push_back(opposingOrderPtr);
+    }
+    return incomingOrder.getStatus() != OrderStatus::CANCELLED;
 }
 
 void DefaultMatchingStrategy::match(Order &incomingOrder,
                                     OrderQueueManager &orderQueueManager,
-                                    std::vector<std::shared_ptr<Order>> &updatedOrders,
+                                    MatchBuffers &buffers,
+                                    SelfTradePrevention selfTradePrevention,
                                     TradeService &tradeService,
                                     EventLogger &eventLogger) const
+{
+    size_t firstFill = buffers.fills.size();
+    size_t firstUpdated = buffers.updatedOrders.size();
+    fill(incomingOrder, orderQueueManager, buffers, selfTradePrevention);
+
+    // Trades, events and their messages are only built once the book has been crossed.
+    settle(std::span<const Fill>(buffers.fills).subspan(firstFill), tradeService, eventLogger);
+
+    // The match loop only cancels orders to prevent self-trades.
+    for (size_t i = firstUpdated; i < buffers.updatedOrders.size(); ++i)
+    {
+        const auto *order = orderQueueManager.getOrder(buffers.updatedOrders[i]);
+        if (order && order->getStatus() == OrderStatus::CANCELLED)
+            eventLogger.logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, *order, generateSelfTradeCancelledMessage(*order)));
+    }
+    if (incomingOrder.getStatus() == OrderStatus::CANCELLED)
+        eventLogger.logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, incomingOrder, generateSelfTradeCancelledMessage(incomingOrder)));
+}
+
+void DefaultMatchingStrategy::fill(Order &incomingOrder,
+                                   OrderQueueManager &orderQueueManager,
+                                   MatchBuffers &buffers,
+                                   SelfTradePrevention selfTradePrevention) const
 {
     int unmatchedQuantity = incomingOrder.getRemainingQuantity();
-    std::vector<std::shared_ptr<Order>> skippedOrders;
 
-    auto &oppositeQueue = (incomingOrder.getSide() == OrderSide::BID)
-                              ? orderQueueManager.getQueue(OrderSide::ASK)
-                              : orderQueueManager.getQueue(OrderSide::BID);
+    auto oppositeSide = (incomingOrder.getSide() == OrderSide::BID) ? OrderSide::ASK : OrderSide::BID;
 
-    while (unmatchedQuantity > 0 && !oppositeQueue.empty())
+    // Walk the book in place: the cursor moves on past orders that leave the book or are skipped, and stays
+    // on an order that is still resting (e.g. a replenished iceberg) so it is matched again.
+    auto opposingHandle = orderQueueManager.getFrontOrder(oppositeSide);
+    while (unmatchedQuantity > 0 && opposingHandle.isValid())
     {
-        auto opposingOrderPtr = oppositeQueue.top();
+        auto &opposingOrder = *orderQueueManager.getOrder(opposingHandle);
+        if (!isPriceAcceptable(incomingOrder, opposingOrder))
+            break;
 
-        if (incomingOrder.getTraderId() == opposingOrderPtr->getTraderId())
+        auto nextHandle = orderQueueManager.getNextOrder(opposingHandle);
+
+        if (incomingOrder.getTraderIndex() == opposingOrder.getTraderIndex())
         {
-            oppositeQueue.pop();
-            skippedOrders.push_back(opposingOrderPtr);
+            if (!preventSelfTrade(incomingOrder, unmatchedQuantity, opposingHandle, opposingOrder,
+                                  selfTradePrevention, orderQueueManager, buffers.updatedOrders))
+                break;
+            opposingHandle = nextHandle;
             continue;
         }
 
-        if (!isPriceAcceptable(incomingOrder, *opposingOrderPtr))
-            break;
-
-        int availableQty = opposingOrderPtr->getRemainingQuantity();
+        int availableQty = opposingOrder.getRemainingQuantity();
         int matchQty = std::min(unmatchedQuantity, availableQty);
 
-        auto &bidOrder = (incomingOrder.getSide() == OrderSide::BID) ? incomingOrder : *opposingOrderPtr;
-        auto &askOrder = (incomingOrder.getSide() == OrderSide::BID) ? *opposingOrderPtr : incomingOrder;
-        Trade trade = tradeService.addTrade(bidOrder, askOrder, matchQty);
-
-        eventLogger.logEvent(std::make_shared<TradeEvent>(EventType::TRADE_EXECUTED, trade, bidOrder.getTraderId(), askOrder.getTraderId()));
+        const auto &bidOrder = (incomingOrder.getSide() == OrderSide::BID) ? incomingOrder : opposingOrder;
+        const auto &askOrder = (incomingOrder.getSide() == OrderSide::BID) ? opposingOrder : incomingOrder;
+        buffers.fills.push_back(Fill{
+            bidOrder.getId(), askOrder.getId(),
+            bidOrder.getType(), askOrder.getType(),
+            bidOrder.getTraderIndex(), askOrder.getTraderIndex(),
+            bidOrder.getPrice(), askOrder.getPrice(),
+            matchQty});
         unmatchedQuantity -= matchQty;
 
-        if (opposingOrderPtr->getType() == OrderType::ICEBERG)
-            processIcebergOrderMatch(opposingOrderPtr, matchQty, availableQty, orderQueueManager, updatedOrders);
+        if (opposingOrder.getType() == OrderType::ICEBERG)
+            processIcebergOrderMatch(opposingHandle, opposingOrder, matchQty, availableQty, orderQueueManager, buffers.updatedOrders);
         else
-            processNormalOrderMatch(opposingOrderPtr, matchQty, availableQty, orderQueueManager, updatedOrders);
-    }
-    for (auto &order : skippedOrders)
-    {
-        oppositeQueue.push(order);
+            processNormalOrderMatch(opposingHandle, opposingOrder, matchQty, availableQty, orderQueueManager, buffers.updatedOrders);
+
+        if (opposingOrder.getStatus() == OrderStatus::FILLED)
+            opposingHandle = nextHandle;
     }
+
     incomingOrder.setRemainingQuantity(unmatchedQuantity);
+    if (incomingOrder.getStatus() == OrderStatus::CANCELLED)
+        return;
     if (unmatchedQuantity == 0)
         incomingOrder.setStatus(OrderStatus::FILLED);
     else if (unmatchedQuantity < incomingOrder.getInitialQuantity())
         incomingOrder.setStatus(OrderStatus::PARTIALLY_FILLED);
+}
 
-    updatedOrders.push_back(std::make_shared<Order>(incomingOrder));
+void DefaultMatchingStrategy::settle(std::span<const Fill> fills,
+                                     TradeService &tradeService,
+                                     EventLogger &eventLogger) const
+{
+    for (const auto &fill : fills)
+    {
+        Trade trade = tradeService.addTrade(fill);
+        eventLogger.logEvent(std::make_shared<TradeEvent>(EventType::TRADE_EXECUTED, trade,
+                                                          TraderIds::name(fill.bidTraderIndex),
+                                                          TraderIds::name(fill.askTraderIndex)));
+    }
 }
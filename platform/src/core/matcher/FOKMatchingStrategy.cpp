@@ -1,54 +1,67 @@
 #include "matcher/FOKMatchingStrategy.hpp"
-#include "matcher/DefaultMatchingStrategy.hpp"
 
 #include <algorithm>
 
 bool FOKMatchingStrategy::isOrderFillable(const Order &order,
-                                          OrderQueueManager &orderQueueManager) const
+                                          OrderQueueManager &orderQueueManager,
+                                          SelfTradePrevention selfTradePrevention) const
 {
     int requiredQty = order.getInitialQuantity();
     int accumulatedQty = 0;
 
-    const auto &oppositeQueue = (order.getSide() == OrderSide::BID)
-                                    ? orderQueueManager.getQueue(OrderSide::ASK)
-                                    : orderQueueManager.getQueue(OrderSide::BID);
-    OrderQueue tempQueue = oppositeQueue;
+    auto oppositeSide = (order.getSide() == OrderSide::BID) ? OrderSide::ASK : OrderSide::BID;
 
-    while (!tempQueue.empty() && accumulatedQty < requiredQty)
+    // Without any of the trader's own orders on the other side, each level's cached total is exactly what
+    // the order can take from it, so only the levels are visited. Otherwise the touched levels are walked
+    // order by order to leave the trader's own liquidity out.
+    bool hasOwnLiquidity = orderQueueManager.getQueuedOrderCount(order.getTraderIndex(), oppositeSide) > 0;
+
+    for (const auto &[price, level] : orderQueueManager.getLevels(oppositeSide))
     {
-        auto opposingOrder = tempQueue.top();
-        tempQueue.pop();
-        if (order.getTraderId() == opposingOrder->getTraderId())
-            continue;
-        if (order.getSide() == OrderSide::BID)
+        if (order.getSide() == OrderSide::BID ? price > order.getPrice() : price < order.getPrice())
+            return false;
+
+        if (!hasOwnLiquidity)
         {
-            if (opposingOrder->getPrice() > order.getPrice())
-                break;
+            accumulatedQty += level.totalQuantity;
         }
         else
         {
-            if (opposingOrder->getPrice() < order.getPrice())
-                break;
+            for (const auto &opposingOrder : level.orders)
+            {
+                if (order.getTraderIndex() == opposingOrder.getTraderIndex())
+                {
+                    // Reaching one of the trader's own orders would cut the fill short under these modes.
+                    if (selfTradePrevention == SelfTradePrevention::CANCEL_NEWEST ||
+                        selfTradePrevention == SelfTradePrevention::DECREMENT_BOTH)
+                        return false;
+                    continue;
+                }
+                accumulatedQty += opposingOrder.getRemainingQuantity();
+                if (accumulatedQty >= requiredQty)
+                    return true;
+            }
         }
-        accumulatedQty += opposingOrder->getRemainingQuantity();
+
+        if (accumulatedQty >= requiredQty)
+            return true;
     }
-    return accumulatedQty >= requiredQty;
+    return false;
 }
 
 void FOKMatchingStrategy::match(Order &incomingOrder,
                                 OrderQueueManager &orderQueueManager,
-                                std::vector<std::shared_ptr<Order>> &updatedOrders,
+                                MatchBuffers &buffers,
+                                SelfTradePrevention selfTradePrevention,
                                 TradeService &tradeService,
                                 EventLogger &eventLogger) const
 {
-    if (!isOrderFillable(incomingOrder, orderQueueManager))
+    if (!isOrderFillable(incomingOrder, orderQueueManager, selfTradePrevention))
     {
         incomingOrder.setStatus(OrderStatus::CANCELLED);
-        updatedOrders.push_back(std::make_shared<Order>(incomingOrder));
         eventLogger.logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, incomingOrder, generateFOKOrderRejectedMessage(incomingOrder)));
         return;
     }
 
-    DefaultMatchingStrategy defaultStrategy;
-    defaultStrategy.match(incomingOrder, orderQueueManager, updatedOrders, tradeService, eventLogger);
+    DefaultMatchingStrategy::match(incomingOrder, orderQueueManager, buffers, selfTradePrevention, tradeService, eventLogger);
 }
@@ -1,22 +1,19 @@
 #include "matcher/IOCMatchingStrategy.hpp"
-#include "matcher/DefaultMatchingStrategy.hpp"
 
 #include <memory>
 
 void IOCMatchingStrategy::match(Order &incomingOrder,
                                 OrderQueueManager &orderQueueManager,
-                                std::vector<std::shared_ptr<Order>> &updatedOrders,
+                                MatchBuffers &buffers,
+                                SelfTradePrevention selfTradePrevention,
                                 TradeService &tradeService,
                                 EventLogger &eventLogger) const
 {
-    DefaultMatchingStrategy defaultStrategy;
-    defaultStrategy.match(incomingOrder, orderQueueManager, updatedOrders, tradeService, eventLogger);
+    DefaultMatchingStrategy::match(incomingOrder, orderQueueManager, buffers, selfTradePrevention, tradeService, eventLogger);
 
-    if (incomingOrder.getRemainingQuantity() > 0)
+    if (incomingOrder.getRemainingQuantity() > 0 && incomingOrder.getStatus() != OrderStatus::CANCELLED)
     {
         incomingOrder.setStatus(OrderStatus::CANCELLED);
         eventLogger.logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, incomingOrder, generateIOCOrderCancelledMessage(incomingOrder)));
     }
-
-    updatedOrders.push_back(std::make_shared<Order>(incomingOrder));
 }
@@ -3,25 +3,28 @@
 #include "matcher/FOKMatchingStrategy.hpp"
 #include "matcher/IOCMatchingStrategy.hpp"
 
-std::shared_ptr<MatchingStrategy> MatchingEngine::getStrategyForOrder(const Order &order) const
-{
-    switch (order.getType())
-    {
-    case OrderType::IOC:
-        return std::make_shared<IOCMatchingStrategy>();
-    case OrderType::FOK:
-        return std::make_shared<FOKMatchingStrategy>();
-    default:
-        return std::make_shared<DefaultMatchingStrategy>();
-    }
-}
+// Strategies hold no state, so one instance of each is shared. Calling them through the concrete objects
+// binds the call statically; no strategy is allocated or dispatched virtually per order.
+static const DefaultMatchingStrategy defaultStrategy;
+static const IOCMatchingStrategy iocStrategy;
+static const FOKMatchingStrategy fokStrategy;
 
 void MatchingEngine::matchOrder(Order &incomingOrder,
                                 OrderQueueManager &orderQueueManager,
                                 TradeService &tradeService,
                                 EventLogger &eventLogger,
-                                std::vector<std::shared_ptr<Order>> &updatedOrders) const
+                                MatchBuffers &buffers) const
 {
-    auto strategy = getStrategyForOrder(incomingOrder);
-    strategy->match(incomingOrder, orderQueueManager, updatedOrders, tradeService, eventLogger);
+    switch (incomingOrder.getType())
+    {
+    case OrderType::IOC:
+        iocStrategy.match(incomingOrder, orderQueueManager, buffers, selfTradePrevention, tradeService, eventLogger);
+        break;
+    case OrderType::FOK:
+        fokStrategy.match(incomingOrder, orderQueueManager, buffers, selfTradePrevention, tradeService, eventLogger);
+        break;
+    default:
+        defaultStrategy.match(incomingOrder, orderQueueManager, buffers, selfTradePrevention, tradeService, eventLogger);
+        break;
+    }
 }
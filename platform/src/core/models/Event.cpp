@@ -5,7 +5,7 @@ std::string generateOrderAddedMessage(const Order &order)
 {
     std::string message = getOrderTypeString(order.getType(), true) + " " + getOrderSideString(order.getSide()) + " order added (";
     message += std::to_string(order.getInitialQuantity()) + " units";
-    if (order.getPrice() > 0)
+    if (order.getPrice().isSet())
         message += " @ $" + formatPrice(order.getPrice());
     message += ")";
     return message;
@@ -15,7 +15,7 @@ std::string generateOrderModifiedMessage(const Order &order)
 {
     std::string message = "Order " + std::to_string(order.getId()) + " modified (";
     message += std::to_string(order.getInitialQuantity()) + " units";
-    if (order.getPrice() > 0)
+    if (order.getPrice().isSet())
         message += " @ $" + formatPrice(order.getPrice());
     message += ")";
     return message;
@@ -49,6 +49,11 @@ std::string generateFOKOrderRejectedMessage(const Order &order)
     return "FOK order cannot be filled and has been cancelled";
 }
 
+std::string generateSelfTradeCancelledMessage(const Order &order)
+{
+    return "Order " + std::to_string(order.getId()) + " cancelled to prevent a self-trade";
+}
+
 std::string generateTradeExecutedMessage(const Trade &trade)
 {
     return "Trade executed (" + std::to_string(trade.getQuantity()) + " units @ $" + formatPrice(trade.getPrice()) + " per unit)";
@@ -131,6 +131,38 @@ bool Trader::placeOrder(const Order &order)
     return true;
 }
 
+TraderState Trader::getState() const
+{
+    return TraderState{
+        traderId,
+        traderName,
+        lots,
+        reservedInventory,
+        totalClosedTrades,
+        avgExitPrice,
+        wins,
+        openPosition,
+        realizedPnL,
+        peakValue,
+        troughValue,
+        maxDrawdown};
+}
+
+void Trader::restoreState(const TraderState &state)
+{
+    traderName = state.traderName;
+    lots = state.lots;
+    reservedInventory = state.reservedInventory;
+    totalClosedTrades = state.totalClosedTrades;
+    avgExitPrice = state.avgExitPrice;
+    wins = state.wins;
+    openPosition = state.openPosition;
+    realizedPnL = state.realizedPnL;
+    peakValue = state.peakValue;
+    troughValue = state.troughValue;
+    maxDrawdown = state.maxDrawdown;
+}
+
 std::vector<Lot> generateInitialLots()
 {
     std::vector<Lot> lots;
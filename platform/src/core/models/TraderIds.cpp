@@ -0,0 +1,60 @@
+#include "models/TraderIds.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+std::shared_mutex TraderIds::mutex;
+std::unordered_map<std::string_view, uint32_t> TraderIds::indexes;
+std::vector<std::unique_ptr<std::string[]>> TraderIds::ownedChunks;
+std::array<std::atomic<std::string *>, TraderIds::MAX_CHUNKS> TraderIds::chunks{};
+std::atomic<uint32_t> TraderIds::count = 0;
+
+uint32_t TraderIds::intern(const std::string &traderId)
+{
+    if (auto traderIndex = find(traderId))
+        return *traderIndex;
+
+    std::unique_lock lock(mutex);
+    auto it = indexes.find(traderId);
+    if (it != indexes.end())
+        return it->second;
+
+    uint32_t traderIndex = count.load(std::memory_order_relaxed);
+    uint32_t chunk = traderIndex / CHUNK_SIZE;
+    if (chunk >= MAX_CHUNKS)
+        throw std::length_error("Too many trader ids");
+    if (traderIndex % CHUNK_SIZE == 0)
+    {
+        ownedChunks.push_back(std::make_unique<std::string[]>(CHUNK_SIZE));
+        chunks[chunk].store(ownedChunks.back().get(), std::memory_order_relaxed);
+    }
+
+    // Chunks never move, so the map can key on views into them. The name is written before the count is
+    // raised, so a reader that sees the new count sees the name too.
+    std::string &slot = chunks[chunk].load(std::memory_order_relaxed)[traderIndex % CHUNK_SIZE];
+    slot = traderId;
+    indexes.emplace(slot, traderIndex);
+    count.store(traderIndex + 1, std::memory_order_release);
+    return traderIndex;
+}
+
+std::optional<uint32_t> TraderIds::find(const std::string &traderId)
+{
+    std::shared_lock lock(mutex);
+    auto it = indexes.find(traderId);
+    if (it == indexes.end())
+        return std::nullopt;
+    return it->second;
+}
+
+const std::string &TraderIds::name(uint32_t traderIndex)
+{
+    if (traderIndex >= count.load(std::memory_order_acquire))
+        throw std::out_of_range("Unknown trader index " + std::to_string(traderIndex));
+    return chunks[traderIndex / CHUNK_SIZE].load(std::memory_order_relaxed)[traderIndex % CHUNK_SIZE];
+}
+
+size_t TraderIds::size()
+{
+    return count.load(std::memory_order_acquire);
+}
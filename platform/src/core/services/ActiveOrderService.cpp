@@ -4,84 +4,102 @@
 #include <stdexcept>
 
 ActiveOrderService::ActiveOrderService(std::shared_ptr<Database> database,
+                                       std::shared_ptr<PersistenceWriter> persistence,
                                        std::shared_ptr<EventLogger> eventLogger,
                                        std::shared_ptr<TradeService> tradeService,
                                        std::shared_ptr<TraderService> traderService)
     : database(database),
+      persistence(persistence),
       eventLogger(eventLogger),
       tradeService(tradeService),
       traderService(traderService)
 {
     auto orders = database->orders()->getAllActive();
     for (const auto &order : orders)
-        orderQueueManager.addOrder(order);
+        orderQueueManager.addOrder(*order);
 }
 
-std::shared_ptr<Order> ActiveOrderService::getOrder(int orderId) const
+Order &ActiveOrderService::getOrder(int orderId)
 {
     return orderQueueManager.getOrder(orderId);
 }
 
-std::shared_ptr<Order> ActiveOrderService::addOrder(const Order &order)
+Order ActiveOrderService::addOrder(const Order &order)
 {
-    auto orderPtr = std::make_shared<Order>(order);
-    orderQueueManager.storeOrder(orderPtr);
-    eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_ADDED, *orderPtr, generateOrderAddedMessage(*orderPtr)));
+    auto handle = orderQueueManager.storeOrder(order);
+    auto &incomingOrder = *orderQueueManager.getOrder(handle);
+    eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_ADDED, incomingOrder, generateOrderAddedMessage(incomingOrder)));
 
-    std::vector<std::shared_ptr<Order>> updatedOrders;
-    matchingEngine.matchOrder(*orderPtr, orderQueueManager, *tradeService, *eventLogger, updatedOrders);
+    matchBuffers.clear();
+    matchingEngine.matchOrder(incomingOrder, orderQueueManager, *tradeService, *eventLogger, matchBuffers);
 
-    for (const auto &order : updatedOrders)
-        database->orders()->update(*order);
+    // A resting order can appear more than once (e.g. a replenished iceberg); once it has been written and
+    // released, its handle goes stale and later occurrences are skipped.
+    for (auto updatedHandle : matchBuffers.updatedOrders)
+    {
+        auto *updatedOrder = orderQueueManager.getOrder(updatedHandle);
+        if (!updatedOrder)
+            continue;
+        persistence->updateOrder(*updatedOrder);
+        if (!isOpenOrder(*updatedOrder))
+            orderQueueManager.releaseOrder(updatedHandle);
+    }
 
-    if (isOpenOrder(*orderPtr))
-        orderQueueManager.enqueueOrder(orderPtr);
+    persistence->updateOrder(incomingOrder);
+    Order result = incomingOrder;
 
-    database->orders()->update(*orderPtr);
-    return orderPtr;
+    if (isOpenOrder(result))
+        orderQueueManager.enqueueOrder(handle);
+    else
+        orderQueueManager.releaseOrder(handle);
+    return result;
 }
 
 bool ActiveOrderService::cancelOrder(int orderId)
 {
-    auto orderPtr = getOrder(orderId);
-    if (!orderPtr || orderPtr->getStatus() != OrderStatus::UNFILLED)
+    auto &order = getOrder(orderId);
+    if (order.getStatus() != OrderStatus::UNFILLED)
         return false;
 
-    orderPtr->setStatus(OrderStatus::CANCELLED);
-    orderQueueManager.removeOrder(orderId, orderPtr->getSide());
-    eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, *orderPtr, generateOrderCancelledMessage(*orderPtr)));
-    database->orders()->update(*orderPtr);
+    order.setStatus(OrderStatus::CANCELLED);
+    eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, order, generateOrderCancelledMessage(order)));
+    persistence->updateOrder(order);
+    orderQueueManager.removeOrder(orderId);
 
     return true;
 }
 
-bool ActiveOrderService::modifyOrder(int orderId, double newPrice, int newQuantity)
+bool ActiveOrderService::modifyOrder(int orderId, Price newPrice, int newQuantity)
 {
-    auto orderPtr = getOrder(orderId);
-    if (!orderPtr || orderPtr->getStatus() != OrderStatus::UNFILLED)
+    auto handle = orderQueueManager.findOrder(orderId);
+    auto &order = getOrder(orderId);
+    if (order.getStatus() != OrderStatus::UNFILLED)
         return false;
-    int oldQuantity = orderPtr->getInitialQuantity();
-    int quantityDiff = newQuantity - oldQuantity;
 
-    orderPtr->setPrice(newPrice);
-    orderPtr->setInitialQuantity(newQuantity);
-    orderPtr->setRemainingQuantity(newQuantity);
+    orderQueueManager.dequeueOrder(handle);
+
+    order.setPrice(newPrice);
+    order.setInitialQuantity(newQuantity);
+    order.setRemainingQuantity(newQuantity);
 
-    orderQueueManager.removeOrder(orderId, orderPtr->getSide());
-    orderQueueManager.addOrder(orderPtr);
+    orderQueueManager.enqueueOrder(handle);
 
-    eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_MODIFIED, *orderPtr, generateOrderModifiedMessage(*orderPtr)));
-    database->orders()->update(*orderPtr);
+    eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_MODIFIED, order, generateOrderModifiedMessage(order)));
+    persistence->updateOrder(order);
     return true;
 }
 
 OrderCounts ActiveOrderService::countOrdersForTrader(const std::string &traderId) const
 {
     OrderCounts counts;
-    for (const auto &pair : orderQueueManager.getOrderMap())
+    auto found = TraderIds::find(traderId);
+    if (!found)
+        return counts;
+    uint32_t traderIndex = *found;
+    for (const auto &[orderId, handle] : orderQueueManager.getOrderMap())
     {
-        const auto &orderPtr = pair.second;
-        if (orderPtr->getTraderId() == traderId && orderPtr->getStatus() == OrderStatus::UNFILLED)
+        const auto *orderPtr = orderQueueManager.getOrder(handle);
+        if (orderPtr->getTraderIndex() == traderIndex && orderPtr->getStatus() == OrderStatus::UNFILLED)
         {
             if (orderPtr->getSide() == OrderSide::BID)
                 ++counts.bids;
@@ -92,22 +110,32 @@ OrderCounts ActiveOrderService::countOrdersForTrader(const std::string &traderId
     return counts;
 }
 
-std::vector<std::shared_ptr<Order>> ActiveOrderService::getBids(int start, int limit) const
+OrderRange ActiveOrderService::getBids(int start, int limit) const
 {
     return orderQueueManager.getOrders(OrderSide::BID, start, limit);
 }
 
-std::vector<std::shared_ptr<Order>> ActiveOrderService::getAsks(int start, int limit) const
+OrderRange ActiveOrderService::getAsks(int start, int limit) const
 {
     return orderQueueManager.getOrders(OrderSide::ASK, start, limit);
 }
 
-std::shared_ptr<Order> ActiveOrderService::getBestBid() const
+std::vector<DepthLevel> ActiveOrderService::getDepth(OrderSide side, int levels) const
+{
+    return orderQueueManager.getDepth(side, levels);
+}
+
+const SideTotals &ActiveOrderService::getTotals(OrderSide side) const
+{
+    return orderQueueManager.getTotals(side);
+}
+
+const Order &ActiveOrderService::getBestBid() const
 {
     return orderQueueManager.getBestOrder(OrderSide::BID);
 }
 
-std::shared_ptr<Order> ActiveOrderService::getBestAsk() const
+const Order &ActiveOrderService::getBestAsk() const
 {
     return orderQueueManager.getBestOrder(OrderSide::ASK);
 }
\ No newline at end of file
@@ -1,158 +1,196 @@
 #include "services/ConditionalOrderService.hpp"
 
-#include <algorithm>
-#include <iostream>
+#include <stdexcept>
+
+ConditionalOrderService::ConditionalOrderService(std::shared_ptr<Database> database,
+                                                 std::shared_ptr<PersistenceWriter> persistence,
+                                                 std::shared_ptr<EventLogger> eventLogger)
+    : persistence(persistence),
+      eventLogger(eventLogger)
+{
+    database->orders()->forEachActiveConditional([this](std::shared_ptr<Order> order)
+                                                 { indexOrder(order); });
+}
 
 std::shared_ptr<Order> ConditionalOrderService::getOrder(int orderId) const
 {
-    auto it = std::find_if(orders.begin(), orders.end(),
-                           [orderId](const std::shared_ptr<Order> &o)
-                           { return o->getId() == orderId; });
-    if (it != orders.end())
-        return *it;
+    auto stopIt = stopsById.find(orderId);
+    if (stopIt != stopsById.end())
+        return stopIt->second->second;
+
+    if (auto orderPtr = trailingBuys.findOrder(orderId))
+        return orderPtr;
+    if (auto orderPtr = trailingSells.findOrder(orderId))
+        return orderPtr;
+
     throw std::runtime_error("Conditional order not found");
 }
 
 std::shared_ptr<Order> ConditionalOrderService::addOrder(const Order &order)
 {
     auto orderPtr = std::make_shared<Order>(order);
-    orders.push_back(orderPtr);
+    indexOrder(orderPtr);
 
     eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_ADDED, *orderPtr, generateOrderAddedMessage(*orderPtr)));
 
     return orderPtr;
 }
 
+void ConditionalOrderService::indexOrder(const std::shared_ptr<Order> &orderPtr)
+{
+    if (orderPtr->getType() == OrderType::TRAILING_STOP)
+        getTrailingStops(orderPtr->getSide()).addOrder(orderPtr);
+    else
+        stopsById[orderPtr->getId()] = getStops(orderPtr->getSide()).emplace(orderPtr->getPrice(), orderPtr);
+}
+
 bool ConditionalOrderService::cancelOrder(int orderId)
 {
-    auto it = std::find_if(orders.begin(), orders.end(),
-                           [orderId](const std::shared_ptr<Order> &o)
-                           { return o->getId() == orderId; });
-    if (it != orders.end())
+    std::shared_ptr<Order> orderPtr;
+
+    auto stopIt = stopsById.find(orderId);
+    if (stopIt != stopsById.end())
     {
-        auto orderPtr = *it;
-        eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, *orderPtr, generateOrderCancelledMessage(*orderPtr)));
-        orders.erase(it);
-        return true;
+        orderPtr = stopIt->second->second;
+        getStops(orderPtr->getSide()).erase(stopIt->second);
+        stopsById.erase(stopIt);
     }
-    return false;
+    else
+    {
+        orderPtr = trailingBuys.removeOrder(orderId);
+        if (!orderPtr)
+            orderPtr = trailingSells.removeOrder(orderId);
+        if (!orderPtr)
+            return false;
+    }
+
+    eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_CANCELLED, *orderPtr, generateOrderCancelledMessage(*orderPtr)));
+    return true;
 }
 
 std::vector<std::shared_ptr<Order>> ConditionalOrderService::getBids(int start, int limit) const
 {
-    std::vector<std::shared_ptr<Order>> bids;
-    auto it = orders.begin();
-    int index = 0;
-    while (it != orders.end() && (limit == -1 || bids.size() < static_cast<size_t>(limit)))
-    {
-        auto orderPtr = *it;
-        if (orderPtr->getSide() == OrderSide::BID)
-        {
-            if (index >= start)
-                bids.push_back(orderPtr);
-            ++index;
-        }
-        ++it;
-    }
-    return bids;
+    return getOrders(OrderSide::BID, start, limit);
 }
 
 std::vector<std::shared_ptr<Order>> ConditionalOrderService::getAsks(int start, int limit) const
 {
-    std::vector<std::shared_ptr<Order>> asks;
-    auto it = orders.begin();
+    return getOrders(OrderSide::ASK, start, limit);
+}
+
+// Stops nearest to triggering first, then trailing stops.
+std::vector<std::shared_ptr<Order>> ConditionalOrderService::getOrders(OrderSide side, int start, int limit) const
+{
+    std::vector<std::shared_ptr<Order>> result;
     int index = 0;
-    while (it != orders.end() && (limit == -1 || asks.size() < static_cast<size_t>(limit)))
+    auto collect = [&](const std::shared_ptr<Order> &orderPtr)
+    {
+        if (limit != -1 && result.size() >= static_cast<size_t>(limit))
+            return false;
+        if (index++ >= start)
+            result.push_back(orderPtr);
+        return true;
+    };
+
+    for (const auto &[price, orderPtr] : getStops(side))
+        if (!collect(orderPtr))
+            return result;
+
+    getTrailingStops(side).forEachOrder(collect);
+    return result;
+}
+
+void ConditionalOrderService::triggerOrders(Price currentMarketPrice, std::vector<std::shared_ptr<Order>> &triggeredOrders)
+{
+    size_t first = triggeredOrders.size();
+    triggerStops(buyStops, currentMarketPrice, triggeredOrders);
+    triggerStops(sellStops, currentMarketPrice, triggeredOrders);
+    trailingBuys.triggerOrders(currentMarketPrice, triggeredOrders);
+    trailingSells.triggerOrders(currentMarketPrice, triggeredOrders);
+    for (size_t i = first; i < triggeredOrders.size(); ++i)
     {
-        auto orderPtr = *it;
-        if (orderPtr->getSide() == OrderSide::ASK)
-        {
-            if (index >= start)
-                asks.push_back(orderPtr);
-            ++index;
-        }
-        ++it;
+        auto &orderPtr = triggeredOrders[i];
+        orderPtr->setStatus(OrderStatus::TRIGGERED);
+        persistence->updateOrder(*orderPtr);
+        eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_TRIGGERED, *orderPtr, generateOrderTriggeredMessage(*orderPtr)));
     }
-    return asks;
 }
 
-std::vector<std::shared_ptr<Order>> ConditionalOrderService::triggerOrders(double currentMarketPrice)
+void ConditionalOrderService::restoreOrder(const std::shared_ptr<Order> &orderPtr)
 {
-    std::vector<std::shared_ptr<Order>> triggeredOrders;
-    auto it = orders.begin();
-    while (it != orders.end())
+    orderPtr->setStatus(OrderStatus::UNFILLED);
+    indexOrder(orderPtr);
+    persistence->updateOrder(*orderPtr);
+}
+
+void ConditionalOrderService::saveTrailingStops()
+{
+    auto save = [this](const std::shared_ptr<Order> &orderPtr)
     {
-        auto &orderPtr = *it;
-        bool trigger = false;
-
-        switch (orderPtr->getType())
-        {
-        case OrderType::STOP:
-        {
-            if ((orderPtr->getSide() == OrderSide::ASK && currentMarketPrice <= orderPtr->getPrice()) ||
-                (orderPtr->getSide() == OrderSide::BID && currentMarketPrice >= orderPtr->getPrice()))
-            {
-                trigger = true;
-            }
-            break;
-        }
-        case OrderType::STOP_LIMIT:
-        {
-            if ((orderPtr->getSide() == OrderSide::ASK && currentMarketPrice <= orderPtr->getPrice()) ||
-                (orderPtr->getSide() == OrderSide::BID && currentMarketPrice >= orderPtr->getPrice()))
-            {
-                trigger = true;
-            }
-            break;
-        }
-        case OrderType::TRAILING_STOP:
-        {
-            if (orderPtr->getSide() == OrderSide::ASK)
-            {
-                if (currentMarketPrice > orderPtr->getBestPrice())
-                    orderPtr->setBestPrice(currentMarketPrice);
-                if (currentMarketPrice <= (orderPtr->getBestPrice() - orderPtr->getPrice()))
-                    trigger = true;
-            }
-            else
-            {
-                if (currentMarketPrice < orderPtr->getBestPrice())
-                    orderPtr->setBestPrice(currentMarketPrice);
-                if (currentMarketPrice >= (orderPtr->getBestPrice() + orderPtr->getPrice()))
-                    trigger = true;
-            }
-            break;
-        }
-        default:
-            break;
-        }
-
-        if (trigger)
-        {
-            triggeredOrders.push_back(orderPtr);
-            eventLogger->logEvent(std::make_shared<OrderEvent>(EventType::ORDER_TRIGGERED, *orderPtr, generateOrderTriggeredMessage(*orderPtr)));
-            it = orders.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
+        persistence->updateOrder(*orderPtr);
+        return true;
+    };
+    trailingBuys.forEachOrder(save);
+    trailingSells.forEachOrder(save);
+}
+
+void ConditionalOrderService::triggerStops(TriggerIndex &stops, Price currentMarketPrice, std::vector<std::shared_ptr<Order>> &triggeredOrders)
+{
+    auto end = stops.upper_bound(currentMarketPrice);
+    for (auto it = stops.begin(); it != end; ++it)
+    {
+        const auto &orderPtr = it->second;
+        triggeredOrders.push_back(orderPtr);
+        stopsById.erase(orderPtr->getId());
     }
-    return triggeredOrders;
+    stops.erase(stops.begin(), end);
+}
+
+const TriggerIndex &ConditionalOrderService::getStops(OrderSide side) const
+{
+    return (side == OrderSide::BID) ? buyStops : sellStops;
+}
+
+TriggerIndex &ConditionalOrderService::getStops(OrderSide side)
+{
+    return (side == OrderSide::BID) ? buyStops : sellStops;
+}
+
+const TrailingStopIndex &ConditionalOrderService::getTrailingStops(OrderSide side) const
+{
+    return (side == OrderSide::BID) ? trailingBuys : trailingSells;
+}
+
+TrailingStopIndex &ConditionalOrderService::getTrailingStops(OrderSide side)
+{
+    return (side == OrderSide::BID) ? trailingBuys : trailingSells;
 }
 
 OrderCounts ConditionalOrderService::countOrdersForTrader(const std::string &traderId) const
 {
     OrderCounts counts;
-    for (const auto &orderPtr : orders)
+    auto found = TraderIds::find(traderId);
+    if (!found)
+        return counts;
+    uint32_t traderIndex = *found;
+    auto count = [&](const Order &order)
     {
-        if (orderPtr->getTraderId() == traderId)
-        {
-            if (orderPtr->getSide() == OrderSide::BID)
-                ++counts.bids;
-            else
-                ++counts.asks;
-        }
-    }
+        if (order.getTraderIndex() != traderIndex)
+            return;
+        if (order.getSide() == OrderSide::BID)
+            ++counts.bids;
+        else
+            ++counts.asks;
+    };
+
+    for (const auto &[orderId, stop] : stopsById)
+        count(*stop->second);
+    auto countTrailing = [&](const std::shared_ptr<Order> &orderPtr)
+    {
+        count(*orderPtr);
+        return true;
+    };
+    trailingBuys.forEachOrder(countTrailing);
+    trailingSells.forEachOrder(countTrailing);
     return counts;
 }
@@ -6,16 +6,28 @@
 #include <ctime>
 #include <cmath>
 
-void MarketService::updatePrice(double newPrice)
+void MarketService::updatePrice(Price newPrice)
 {
     currentPrice = newPrice;
 
     if (priceHistory.size() >= MAX_HISTORY_SIZE)
         priceHistory.pop_front();
 
-    priceHistory.push_back(newPrice);
+    priceHistory.push_back(newPrice.toDouble());
     volatility = calculateVolatility();
-    traderService->updateTradersDrawdown(currentPrice);
+    traderService->updateTradersDrawdown(currentPrice.toDouble());
+}
+
+MarketState MarketService::getState() const
+{
+    return MarketState{currentPrice, volatility, std::vector<double>(priceHistory.begin(), priceHistory.end())};
+}
+
+void MarketService::restoreState(const MarketState &state)
+{
+    currentPrice = state.currentPrice;
+    volatility = state.volatility;
+    priceHistory.assign(state.priceHistory.begin(), state.priceHistory.end());
 }
 
 double MarketService::calculateVolatility()
@@ -6,7 +6,7 @@
 bool RiskService::checkOrder(const Order &order, double currentMarketPrice)
 {
     RiskLimits limits = getEffectiveLimits(order.getTraderId());
-    auto trader = traderService->getTrader(order.getTraderId());
+    auto trader = traderService->getTraderByIndex(order.getTraderIndex());
 
     if (order.getInitialQuantity() > limits.maxOrderSize)
         return false;
@@ -28,7 +28,7 @@ bool RiskService::checkOrder(const Order &order, double currentMarketPrice)
 
     if (order.getSide() == OrderSide::ASK)
     {
-        double orderPrice = (order.getPrice() != -1) ? order.getPrice() : currentMarketPrice;
+        double orderPrice = order.getPrice().isSet() ? order.getPrice().toDouble() : currentMarketPrice;
         double orderNotional = orderPrice * order.getInitialQuantity();
         double portfolioValue = trader->getInventory() * trader->getAvgEntryPrice();
         if (portfolioValue > 0)
@@ -1,81 +1,172 @@
 #include "services/TradeService.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 
 TradeService::TradeService(
     std::shared_ptr<Database> database,
+    std::shared_ptr<PersistenceWriter> persistence,
     std::shared_ptr<EventLogger> eventLogger,
     std::shared_ptr<MarketService> marketService,
     std::shared_ptr<TraderService> traderService)
     : database(database),
+      persistence(persistence),
       eventLogger(eventLogger),
       marketService(marketService),
-      traderService(traderService)
+      traderService(traderService),
+      tradeIds(database->trades()->getLastId())
 {
-    trades = database->trades()->getAll();
+    totals = database->trades()->getTotals();
+    auto page = database->trades()->getPage(tradeIds.last() + 1, static_cast<int>(RECENT_TRADES));
+    for (auto it = page.rbegin(); it != page.rend(); ++it)
+        recentTrades.push(std::move(*it));
 }
 
-Trade TradeService::addTrade(Order &bidOrder, Order &askOrder, int quantity)
+void TradeService::recordTotals(const Trade &trade)
 {
-    double bidPrice = bidOrder.getPrice();
-    double askPrice = askOrder.getPrice();
+    ++totals.count;
+    totals.volume += trade.getQuantity();
+    totals.notional += trade.getQuantity() * trade.getPrice().toDouble();
+}
+
+Trade TradeService::addTrade(const Fill &fill)
+{
+    Price bidPrice = fill.bidPrice;
+    Price askPrice = fill.askPrice;
 
-    double tradePrice = marketService->getCurrentPrice();
-    if (bidPrice == -1 && askPrice > 0) {
+    Price tradePrice = marketService->getCurrentPrice();
+    if (!bidPrice.isSet() && askPrice.isSet()) {
         tradePrice = askPrice;
-    } else if (askPrice == -1 && bidPrice > 0) {
+    } else if (!askPrice.isSet() && bidPrice.isSet()) {
         tradePrice = bidPrice;
-    } else if (bidPrice > 0 && askPrice > 0) {
+    } else if (bidPrice.isSet() && askPrice.isSet()) {
         tradePrice = askPrice;
     } 
 
-    Trade trade(bidOrder.getId(), askOrder.getId(), bidOrder.getType(), askOrder.getType(), quantity, tradePrice);
+    Trade trade(fill.bidOrderId, fill.askOrderId, fill.bidType, fill.askType, fill.quantity, tradePrice);
+    trade.setTraders(fill.bidTraderIndex, fill.askTraderIndex);
+
+    trade.setId(tradeIds.next());
+    persistence->insertTrade(trade);
+    recentTrades.push(trade);
+    recordTotals(trade);
 
-    int tradeId = database->trades()->create(trade);
-    trade.setId(tradeId);
-    trades.push_back(trade);
+    applyToPositions(trade);
+    if (tradeListener)
+        tradeListener(trade);
 
-    auto buyTrader = traderService->getTrader(bidOrder.getTraderId());
-    auto sellTrader = traderService->getTrader(askOrder.getTraderId());
+    return trade;
+}
+
+void TradeService::applyToPositions(const Trade &trade)
+{
+    auto buyTrader = traderService->getTraderByIndex(trade.getBuyTraderIndex());
+    auto sellTrader = traderService->getTraderByIndex(trade.getSellTraderIndex());
 
-    buyTrader->buy(trade.getQuantity(), trade.getPrice());
-    sellTrader->sell(trade.getQuantity(), trade.getPrice());
+    buyTrader->buy(trade.getQuantity(), trade.getPrice().toDouble());
+    sellTrader->sell(trade.getQuantity(), trade.getPrice().toDouble());
 
+    // Queued after the price update so the drawdowns it moves are stored too.
     marketService->updatePrice(trade.getPrice());
+    persistence->updateTrader(buyTrader->getState());
+    persistence->updateTrader(sellTrader->getState());
+}
 
-    return trade;
+size_t TradeService::lowerBound(int tradeId) const
+{
+    size_t low = 0;
+    size_t high = recentTrades.size();
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (recentTrades[mid].getId() < tradeId)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+std::vector<Trade> TradeService::readPage(int beforeId, int limit) const
+{
+    // A trade pushed out of recentTrades may not have reached storage yet. The writer is only flushed when
+    // the page could reach such a trade, so reading older history does not hold up matching behind a commit.
+    if (beforeId - 1 > persistence->getStoredTradeId())
+        persistence->flush();
+    std::lock_guard lock(database->getMutex());
+    return database->trades()->getPage(beforeId, limit);
 }
 
 Trade TradeService::getTrade(int tradeId) const
 {
-    for (const auto &trade : trades)
+    if (!recentTrades.empty())
     {
-        if (trade.getId() == tradeId)
-            return trade;
+        // Ids are handed out in sequence, so a trade normally sits at its id's offset from the oldest one
+        // held. Trades loaded from older databases may have gaps, which the search covers.
+        long long offset = static_cast<long long>(tradeId) - recentTrades.front().getId();
+        if (offset >= 0 && offset < static_cast<long long>(recentTrades.size()) &&
+            recentTrades[static_cast<size_t>(offset)].getId() == tradeId)
+            return recentTrades[static_cast<size_t>(offset)];
+
+        size_t index = lowerBound(tradeId);
+        if (index < recentTrades.size() && recentTrades[index].getId() == tradeId)
+            return recentTrades[index];
+    }
+    if (recentTrades.empty() || tradeId < recentTrades.front().getId())
+    {
+        auto page = readPage(tradeId + 1, 1);
+        if (!page.empty() && page.front().getId() == tradeId)
+            return page.front();
     }
     throw std::runtime_error("Trade not found");
 }
 
 std::vector<Trade> TradeService::getTrades(int start, int limit) const
 {
-    int sizeLimit = limit > 0 ? limit : trades.size();
-    int startIndex = static_cast<int>(trades.size()) - 1 - start;
+    int sizeLimit = limit > 0 ? limit : totals.count;
+    int held = static_cast<int>(recentTrades.size());
+    int startIndex = held - 1 - start;
 
     std::vector<Trade> result;
-    result.reserve(std::min<size_t>(sizeLimit, trades.size()));
+    result.reserve(std::min(sizeLimit, held));
 
-    if (startIndex < 0)
+    if (startIndex >= 0)
     {
-        return result;
+        int endIndex = std::max(0, startIndex - (sizeLimit - 1));
+        for (int i = startIndex; i >= endIndex; --i)
+            result.push_back(recentTrades[i]);
     }
 
-    int endIndex = std::max(0, startIndex - (sizeLimit - 1));
+    int remaining = sizeLimit - static_cast<int>(result.size());
+    if (remaining <= 0 || totals.count <= held)
+        return result;
 
-    for (int i = startIndex; i >= endIndex; --i)
-    {
-        result.push_back(trades[i]);
-    }
+    int skip = std::max(0, start - held);
+    int beforeId = recentTrades.empty() ? tradeIds.last() + 1 : recentTrades.front().getId();
+    auto page = readPage(beforeId, skip + remaining);
+    for (size_t i = skip; i < page.size(); ++i)
+        result.push_back(std::move(page[i]));
 
     return result;
 }
 
+std::vector<Trade> TradeService::getTradesBefore(int beforeId, int limit) const
+{
+    int sizeLimit = limit > 0 ? limit : totals.count;
+
+    std::vector<Trade> result;
+    for (size_t i = lowerBound(beforeId); i > 0 && static_cast<int>(result.size()) < sizeLimit; --i)
+        result.push_back(recentTrades[i - 1]);
+
+    int remaining = sizeLimit - static_cast<int>(result.size());
+    if (remaining <= 0 || totals.count <= static_cast<int>(recentTrades.size()))
+        return result;
+
+    int oldestHeld = recentTrades.empty() ? tradeIds.last() + 1 : recentTrades.front().getId();
+    auto page = readPage(std::min(beforeId, oldestHeld), remaining);
+    for (auto &trade : page)
+        result.push_back(std::move(trade));
+
+    return result;
+}
@@ -1,20 +1,46 @@
 #include <services/TraderService.hpp>
+#include <models/TraderIds.hpp>
 
 #include <memory>
 
 std::shared_ptr<Trader> TraderService::getTrader(const std::string &traderId)
 {
-    if (traders.find(traderId) == traders.end())
+    return getTraderByIndex(TraderIds::intern(traderId));
+}
+
+std::shared_ptr<Trader> TraderService::getTraderByIndex(uint32_t traderIndex)
+{
+    if (traderIndex >= traders.size())
+        traders.resize(traderIndex + 1);
+
+    auto &trader = traders[traderIndex];
+    if (!trader)
+        trader = std::make_shared<Trader>(TraderIds::name(traderIndex));
+    return trader;
+}
+
+std::vector<TraderState> TraderService::getTraderStates() const
+{
+    std::vector<TraderState> states;
+    for (const auto &trader : traders)
     {
-        traders[traderId] = std::make_shared<Trader>(traderId);
+        if (trader)
+            states.push_back(trader->getState());
     }
-    return traders[traderId];
+    return states;
+}
+
+void TraderService::restoreTraders(const std::vector<TraderState> &states)
+{
+    for (const auto &state : states)
+        getTrader(state.traderId)->restoreState(state);
 }
 
 void TraderService::updateTradersDrawdown(double currentPrice)
 {
     for (const auto &trader : traders)
     {
-        trader.second->updateMaxDrawdown(currentPrice);
+        if (trader)
+            trader->updateMaxDrawdown(currentPrice);
     }
 }
@@ -67,14 +67,16 @@ std::string getOrderStatusString(OrderStatus orderStatus)
         return "FILLED";
     case OrderStatus::CANCELLED:
         return "CANCELLED";
+    case OrderStatus::TRIGGERED:
+        return "TRIGGERED";
     default:
         return "UNKNOWN";
     }
 }
 
-std::string formatPrice(double price)
+std::string formatPrice(Price price)
 {
     std::ostringstream stream;
-    stream << std::fixed << std::setprecision(2) << price;
+    stream << std::fixed << std::setprecision(2) << price.toDouble();
     return stream.str();
 }
\ No newline at end of file
@@ -50,9 +50,9 @@ crow::json::wvalue orderToJson(const Order &order)
     obj["traderId"] = order.getTraderId();
     obj["timestamp"] = order.getTimestamp();
 
-    if (order.getPrice() != -1)
+    if (order.getPrice().isSet())
     {
-        obj["price"] = order.getPrice();
+        obj["price"] = order.getPrice().toDouble();
     }
     else
     {
@@ -72,12 +72,12 @@ crow::json::wvalue orderToJson(const Order &order)
 
     if (order.getType() == OrderType::STOP_LIMIT)
     {
-        obj["limitPrice"] = order.getLimitPrice();
+        obj["limitPrice"] = order.getLimitPrice().toDouble();
     }
 
     if (order.getType() == OrderType::TRAILING_STOP)
     {
-        obj["bestPrice"] = order.getBestPrice();
+        obj["bestPrice"] = order.getBestPrice().toDouble();
     }
 
     return obj;
@@ -92,7 +92,7 @@ crow::json::wvalue tradeToJson(const Trade &trade)
     obj["sellOrderId"] = trade.getSellOrderId();
     obj["buyOrderType"] = getOrderTypeString(trade.getBuyOrderType());
     obj["sellOrderType"] = getOrderTypeString(trade.getSellOrderType());
-    obj["price"] = trade.getPrice();
+    obj["price"] = trade.getPrice().toDouble();
     obj["quantity"] = trade.getQuantity();
     obj["timestamp"] = trade.getTimestamp();
 
@@ -115,8 +115,8 @@ crow::json::wvalue traderToJson(std::shared_ptr<Trader> trader, std::shared_ptr<
     obj["avgEntryPrice"] = trader->getAvgEntryPrice();
     obj["avgExitPrice"] = trader->getAvgExitPrice();
     obj["realizedPnL"] = trader->getRealizedPnL();
-    obj["unrealizedPnL"] = trader->getUnrealizedPnL(market->getCurrentPrice());
-    obj["maxDrawdown"] = trader->getMaxDrawdown(market->getCurrentPrice());
+    obj["unrealizedPnL"] = trader->getUnrealizedPnL(market->getCurrentPrice().toDouble());
+    obj["maxDrawdown"] = trader->getMaxDrawdown(market->getCurrentPrice().toDouble());
 
     return obj;
 }
@@ -125,7 +125,7 @@ crow::json::wvalue marketDataToJson(MarketData &marketData)
 {
     crow::json::wvalue obj;
 
-    obj["currentPrice"] = marketData.marketPrice;
+    obj["currentPrice"] = marketData.marketPrice.toDouble();
     obj["volatility"] = marketData.volatility;
     obj["bids"]["count"] = marketData.bids.count;
     obj["bids"]["volume"] = marketData.bids.volume;
@@ -148,6 +148,15 @@ crow::json::wvalue marketDataToJson(MarketData &marketData)
     return obj;
 }
 
+crow::json::wvalue depthLevelToJson(const DepthLevel &level)
+{
+    crow::json::wvalue obj;
+    obj["price"] = level.price.toDouble();
+    obj["quantity"] = level.quantity;
+    obj["orderCount"] = level.orderCount;
+    return obj;
+}
+
 crow::json::wvalue riskLimitsToJson(const RiskLimits &limits)
 {
     crow::json::wvalue obj;
@@ -160,6 +169,23 @@ crow::json::wvalue riskLimitsToJson(const RiskLimits &limits)
     return obj;
 }
 
+namespace
+{
+    // Price::fromDouble rounds to the nearest tick and turns anything not positive into an unset price,
+    // which the book treats as a market order, so prices from clients are checked before they get there.
+    double parsePrice(const crow::json::rvalue &json, const char *field)
+    {
+        if (!json.has(field))
+            throw std::invalid_argument(std::string("Missing ") + field);
+        double value = json[field].d();
+        if (!(value > 0))
+            throw std::invalid_argument(std::string(field) + " must be positive");
+        if (!Price::isOnTick(value))
+            throw std::invalid_argument(std::string(field) + " must be a whole number of ticks");
+        return value;
+    }
+}
+
 std::unique_ptr<Order> createOrderFromJson(OrderType type, const crow::json::rvalue &json,
                                            OrderSide side, int quantity,
                                            const std::string &traderId)
@@ -169,24 +195,34 @@ std::unique_ptr<Order> createOrderFromJson(OrderType type, const crow::json::rva
     case OrderType::MARKET:
         return std::make_unique<MarketOrder>(side, quantity, traderId);
     case OrderType::LIMIT:
-        return std::make_unique<LimitOrder>(side, quantity, traderId, json["price"].d());
+        return std::make_unique<LimitOrder>(side, quantity, traderId, parsePrice(json, "price"));
     case OrderType::IOC:
-        return std::make_unique<IOCOrder>(side, quantity, traderId, json["price"].d());
+        return std::make_unique<IOCOrder>(side, quantity, traderId, parsePrice(json, "price"));
     case OrderType::FOK:
-        return std::make_unique<FOKOrder>(side, quantity, traderId, json["price"].d());
+        return std::make_unique<FOKOrder>(side, quantity, traderId, parsePrice(json, "price"));
     case OrderType::STOP:
-        return std::make_unique<StopOrder>(side, quantity, traderId, json["price"].d());
+        return std::make_unique<StopOrder>(side, quantity, traderId, parsePrice(json, "price"));
     case OrderType::STOP_LIMIT:
-        return std::make_unique<StopLimitOrder>(side, quantity, traderId, json["price"].d(), json["limitPrice"].d());
+        return std::make_unique<StopLimitOrder>(side, quantity, traderId, parsePrice(json, "price"), parsePrice(json, "limitPrice"));
     case OrderType::TRAILING_STOP:
-        return std::make_unique<TrailingStopOrder>(side, quantity, traderId, json["price"].d(), json["bestPrice"].d());
+        return std::make_unique<TrailingStopOrder>(side, quantity, traderId, parsePrice(json, "price"), parsePrice(json, "bestPrice"));
     case OrderType::ICEBERG:
     {
         int displaySize = json["displaySize"].i();
         int hiddenQuantity = quantity - displaySize;
-        return std::make_unique<IcebergOrder>(side, quantity, traderId, json["price"].d(), displaySize, hiddenQuantity);
+        return std::make_unique<IcebergOrder>(side, quantity, traderId, parsePrice(json, "price"), displaySize, hiddenQuantity);
     }
     default:
         throw std::invalid_argument("Invalid order type");
     }
 }
+
+std::unique_ptr<Order> parseOrderJson(const crow::json::rvalue &json)
+{
+    OrderType type = parseOrderType(json["orderType"].s());
+    OrderSide side = (std::string(json["side"].s()) == "BID") ? OrderSide::BID : OrderSide::ASK;
+    int quantity = json["quantity"].i();
+    std::string traderId = json["traderId"].s();
+
+    return createOrderFromJson(type, json, side, quantity, traderId);
+}
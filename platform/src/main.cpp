@@ -1,26 +1,96 @@
 #include "api/Server.hpp"
+#include "core/models/Price.hpp"
 
+#include <chrono>
 #include <iostream>
+#include <optional>
+#include <string>
 #include <thread>
 
 int main(int argc, char *argv[])
 {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <db_file_path>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <db_file_path> [--tick-size=<value>] [--cascade-limit=<orders>]"
+                  << " [--flush-interval-ms=<ms>] [--durability=write-behind|commit]"
+                  << " [--storage=baseline|wal|fast] [--backend=sqlite|journal] [--snapshot-interval-s=<seconds>]"
+                  << std::endl;
         return 1;
     }
 
     std::string dbFilePath = argv[1];
+    std::string snapshotPath = dbFilePath + ".snapshot";
+    std::chrono::seconds snapshotInterval(60);
+    std::optional<size_t> cascadeLimit;
+    StorageOptions storageOptions;
+    StorageBackend backend = StorageBackend::SQLITE;
+    PersistenceOptions persistenceOptions;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--tick-size=", 0) == 0)
+            Price::setTickSize(std::stod(arg.substr(12)));
+        else if (arg.rfind("--cascade-limit=", 0) == 0)
+            cascadeLimit = std::stoul(arg.substr(16));
+        else if (arg.rfind("--flush-interval-ms=", 0) == 0)
+            persistenceOptions.flushInterval = std::chrono::milliseconds(std::stol(arg.substr(20)));
+        else if (arg == "--durability=commit")
+            persistenceOptions.durability = Durability::COMMIT_BEFORE_RETURN;
+        else if (arg == "--durability=write-behind")
+            persistenceOptions.durability = Durability::WRITE_BEHIND;
+        else if (arg.rfind("--storage=", 0) == 0)
+            storageOptions = StorageOptions::fromProfile(arg.substr(10));
+        else if (arg == "--backend=journal")
+            backend = StorageBackend::JOURNAL;
+        else if (arg == "--backend=sqlite")
+            backend = StorageBackend::SQLITE;
+        else if (arg.rfind("--snapshot-interval-s=", 0) == 0)
+            snapshotInterval = std::chrono::seconds(std::stol(arg.substr(22)));
+    }
+    storageOptions.backend = backend;
     std::cout << "Starting API Server with database file: " << dbFilePath << std::endl;
 
-    Server server(dbFilePath);
+    Server server(dbFilePath, storageOptions, persistenceOptions);
+    if (cascadeLimit)
+        server.book->setCascadeLimit(*cascadeLimit);
+    // The snapshot only holds market state, so one that cannot be read is reported rather than fatal.
+    try
+    {
+        if (server.book->loadSnapshot(snapshotPath))
+            std::cout << "Restored snapshot " << snapshotPath << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Failed to restore snapshot: " << ex.what() << std::endl;
+    }
 
     std::thread apiThread([&server]() { server.start(); });
     apiThread.detach();
 
+    auto lastSnapshot = std::chrono::steady_clock::now();
     while (true)
     {
         std::this_thread::sleep_for(std::chrono::seconds(10));
+        try
+        {
+            server.book->saveTrailingStops();
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << "Failed to save trailing stops: " << ex.what() << std::endl;
+        }
+
+        if (std::chrono::steady_clock::now() - lastSnapshot < snapshotInterval)
+            continue;
+        lastSnapshot = std::chrono::steady_clock::now();
+        try
+        {
+            server.book->saveSnapshot(snapshotPath);
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << "Failed to save snapshot: " << ex.what() << std::endl;
+        }
     }
 
     return 0;
@@ -1,4 +1,5 @@
 #include "OrderBook.hpp"
+#include "database/SqliteDatabase.hpp"
 #include "mocks/MockDatabase.hpp"
 #include "mocks/MockRiskService.hpp"
 
@@ -222,6 +223,452 @@ TEST_F(ActiveOrderTest, IcebergOrderTest)
     EXPECT_EQ(bestBid.getHiddenQuantity(), 40);
 }
 
+TEST_F(ActiveOrderTest, DepthTracksAddFillAndCancel)
+{
+    auto askPayload1 = LimitOrder(OrderSide::ASK, 10, "TraderD1", 101.0);
+    auto askPayload2 = LimitOrder(OrderSide::ASK, 15, "TraderD2", 101.0);
+    auto askPayload3 = LimitOrder(OrderSide::ASK, 5, "TraderD3", 102.0);
+    auto askOrder1 = orderBook.addOrder(askPayload1);
+    auto askOrder2 = orderBook.addOrder(askPayload2);
+    auto askOrder3 = orderBook.addOrder(askPayload3);
+
+    auto depth = orderBook.getDepth(OrderSide::ASK);
+    ASSERT_EQ(depth.size(), 2);
+    EXPECT_EQ(depth[0].price, Price::fromDouble(101.0));
+    EXPECT_EQ(depth[0].quantity, 25);
+    EXPECT_EQ(depth[0].orderCount, 2);
+    EXPECT_EQ(depth[1].price, Price::fromDouble(102.0));
+    EXPECT_EQ(depth[1].quantity, 5);
+
+    auto bidPayload = LimitOrder(OrderSide::BID, 12, "TraderD4", 101.0);
+    orderBook.addOrder(bidPayload);
+
+    depth = orderBook.getDepth(OrderSide::ASK);
+    EXPECT_EQ(depth[0].quantity, 13);
+    EXPECT_EQ(depth[0].orderCount, 1);
+
+    orderBook.cancelOrder(askOrder3.getId());
+    depth = orderBook.getDepth(OrderSide::ASK);
+    ASSERT_EQ(depth.size(), 1);
+    EXPECT_EQ(depth[0].price, Price::fromDouble(101.0));
+}
+
+TEST_F(ActiveOrderTest, PagedOrdersFollowPriceTimePriority)
+{
+    std::vector<int> ids;
+    for (int i = 0; i < 6; ++i)
+    {
+        auto payload = LimitOrder(OrderSide::BID, 1, "TraderP" + std::to_string(i), 100.0 + (i % 3));
+        ids.push_back(orderBook.addOrder(payload).getId());
+    }
+
+    auto page = orderBook.getActiveBids(1, 3);
+    ASSERT_EQ(page.size(), 3);
+    EXPECT_EQ(page[0].getId(), ids[5]);
+    EXPECT_EQ(page[1].getId(), ids[1]);
+    EXPECT_EQ(page[2].getId(), ids[4]);
+}
+
+TEST_F(ActiveOrderTest, MarketDataAggregatesRestingAndTradedVolume)
+{
+    auto askPayload1 = LimitOrder(OrderSide::ASK, 10, "TraderM1", 100.0);
+    auto askPayload2 = LimitOrder(OrderSide::ASK, 10, "TraderM2", 102.0);
+    auto bidPayload1 = LimitOrder(OrderSide::BID, 4, "TraderM3", 98.0);
+    auto bidPayload2 = LimitOrder(OrderSide::BID, 15, "TraderM4", 102.0);
+    orderBook.addOrder(askPayload1);
+    orderBook.addOrder(askPayload2);
+    orderBook.addOrder(bidPayload1);
+    orderBook.addOrder(bidPayload2);
+
+    auto data = orderBook.getMarketData();
+    EXPECT_EQ(data.asks.count, 1);
+    EXPECT_EQ(data.asks.volume, 5);
+    EXPECT_EQ(data.bids.count, 1);
+    EXPECT_EQ(data.bids.volume, 4);
+    EXPECT_EQ(data.trades.count, 2);
+    EXPECT_EQ(data.trades.volume, 15);
+    EXPECT_DOUBLE_EQ(data.trades.avgPrice, (10 * 100.0 + 5 * 102.0) / 15);
+}
+
+TEST_F(ActiveOrderTest, CountingUnknownTraderDoesNotInternIt)
+{
+    auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderKnown", 101.0);
+    orderBook.addOrder(askPayload);
+
+    size_t internedBefore = TraderIds::size();
+    auto counts = orderBook.countOrdersForTrader("TraderNeverSeen");
+    EXPECT_EQ(counts.asks, 0);
+    EXPECT_EQ(counts.bids, 0);
+    EXPECT_EQ(TraderIds::size(), internedBefore);
+    EXPECT_FALSE(TraderIds::find("TraderNeverSeen"));
+    EXPECT_EQ(orderBook.countOrdersForTrader("TraderKnown").asks, 1);
+}
+
+TEST_F(ActiveOrderTest, FilledOrdersLeaveTheBook)
+{
+    auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderF1", 101.0);
+    auto askOrder = orderBook.addOrder(askPayload);
+
+    auto bidPayload = LimitOrder(OrderSide::BID, 10, "TraderF2", 101.0);
+    auto bidOrder = orderBook.addOrder(bidPayload);
+
+    EXPECT_FALSE(orderBook.cancelOrder(askOrder.getId()));
+    EXPECT_FALSE(orderBook.cancelOrder(bidOrder.getId()));
+    EXPECT_EQ(orderBook.countOrdersForTrader("TraderF1").asks, 0);
+
+    // The released slots are reused without disturbing orders that are still resting.
+    auto restingPayload = LimitOrder(OrderSide::ASK, 5, "TraderF3", 102.0);
+    auto restingOrder = orderBook.addOrder(restingPayload);
+    auto replacementPayload = LimitOrder(OrderSide::ASK, 5, "TraderF4", 103.0);
+    orderBook.addOrder(replacementPayload);
+
+    EXPECT_EQ(orderBook.getBestAsk().getId(), restingOrder.getId());
+    EXPECT_TRUE(orderBook.cancelOrder(restingOrder.getId()));
+    EXPECT_EQ(orderBook.getActiveAsks().size(), 1);
+}
+
+TEST_F(ActiveOrderTest, SelfTradeSkipMatchesPastOwnOrder)
+{
+    auto ownPayload = LimitOrder(OrderSide::ASK, 10, "TraderS1", 101.0);
+    auto otherPayload = LimitOrder(OrderSide::ASK, 10, "TraderS2", 101.0);
+    auto ownAsk = orderBook.addOrder(ownPayload);
+    orderBook.addOrder(otherPayload);
+
+    auto bidPayload = LimitOrder(OrderSide::BID, 10, "TraderS1", 101.0);
+    orderBook.addOrder(bidPayload);
+
+    EXPECT_EQ(orderBook.getTrades(0, -1).size(), 1);
+    EXPECT_EQ(orderBook.getBestAsk().getId(), ownAsk.getId());
+    EXPECT_TRUE(orderBook.getActiveBids().empty());
+}
+
+TEST_F(ActiveOrderTest, SelfTradeCancelNewestCancelsIncoming)
+{
+    orderBook.setSelfTradePrevention(SelfTradePrevention::CANCEL_NEWEST);
+
+    auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderS3", 101.0);
+    auto ask = orderBook.addOrder(askPayload);
+    auto bidPayload = LimitOrder(OrderSide::BID, 10, "TraderS3", 101.0);
+    orderBook.addOrder(bidPayload);
+
+    EXPECT_TRUE(orderBook.getTrades(0, -1).empty());
+    EXPECT_EQ(orderBook.getBestAsk().getId(), ask.getId());
+    EXPECT_TRUE(orderBook.getActiveBids().empty());
+}
+
+TEST_F(ActiveOrderTest, SelfTradeCancelOldestCancelsResting)
+{
+    orderBook.setSelfTradePrevention(SelfTradePrevention::CANCEL_OLDEST);
+
+    auto ownPayload = LimitOrder(OrderSide::ASK, 10, "TraderS4", 101.0);
+    auto otherPayload = LimitOrder(OrderSide::ASK, 10, "TraderS5", 101.0);
+    orderBook.addOrder(ownPayload);
+    orderBook.addOrder(otherPayload);
+
+    auto bidPayload = LimitOrder(OrderSide::BID, 10, "TraderS4", 101.0);
+    orderBook.addOrder(bidPayload);
+
+    EXPECT_EQ(orderBook.getTrades(0, -1).size(), 1);
+    EXPECT_TRUE(orderBook.getActiveAsks().empty());
+    EXPECT_TRUE(orderBook.getActiveBids().empty());
+}
+
+TEST_F(ActiveOrderTest, SelfTradeDecrementBothReducesResting)
+{
+    orderBook.setSelfTradePrevention(SelfTradePrevention::DECREMENT_BOTH);
+
+    auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderS6", 101.0);
+    orderBook.addOrder(askPayload);
+    auto bidPayload = LimitOrder(OrderSide::BID, 4, "TraderS6", 101.0);
+    orderBook.addOrder(bidPayload);
+
+    auto depth = orderBook.getDepth(OrderSide::ASK);
+    EXPECT_TRUE(orderBook.getTrades(0, -1).empty());
+    ASSERT_EQ(depth.size(), 1);
+    EXPECT_EQ(depth[0].quantity, 6);
+    EXPECT_TRUE(orderBook.getActiveBids().empty());
+
+    // Larger than the resting order: the resting order is cancelled and the rest of the bid stays in the
+    // book as if it had been entered smaller, still cancellable.
+    auto ownAsk = LimitOrder(OrderSide::ASK, 4, "TraderS7", 99.0);
+    orderBook.addOrder(ownAsk);
+    auto largeBid = LimitOrder(OrderSide::BID, 10, "TraderS7", 99.0);
+    auto bid = orderBook.addOrder(largeBid);
+
+    EXPECT_TRUE(orderBook.getTrades(0, -1).empty());
+    EXPECT_EQ(bid.getStatus(), OrderStatus::UNFILLED);
+    EXPECT_EQ(bid.getRemainingQuantity(), 6);
+    EXPECT_EQ(bid.getInitialQuantity(), 6);
+    EXPECT_EQ(orderBook.getActiveAsks().size(), 1);
+    EXPECT_TRUE(orderBook.cancelOrder(bid.getId()));
+}
+
+TEST_F(ActiveOrderTest, SelfTradeDecrementBothKeepsPartialFillOfResting)
+{
+    orderBook.setSelfTradePrevention(SelfTradePrevention::DECREMENT_BOTH);
+
+    auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderS9", 101.0);
+    int askId = orderBook.addOrder(askPayload).getId();
+    auto otherBid = LimitOrder(OrderSide::BID, 6, "TraderS10", 101.0);
+    orderBook.addOrder(otherBid);
+
+    // Decrementing by less than is left keeps the fill: 6 of the remaining 8 were traded.
+    auto smallBid = LimitOrder(OrderSide::BID, 2, "TraderS9", 101.0);
+    orderBook.addOrder(smallBid);
+    auto ask = orderBook.getBestAsk();
+    EXPECT_EQ(ask.getId(), askId);
+    EXPECT_EQ(ask.getInitialQuantity(), 8);
+    EXPECT_EQ(ask.getRemainingQuantity(), 2);
+    EXPECT_EQ(ask.getStatus(), OrderStatus::PARTIALLY_FILLED);
+
+    // Decrementing by all that is left cancels it with nothing remaining, not its whole reduced size.
+    std::shared_ptr<Order> cancelled;
+    auto bigBid = LimitOrder(OrderSide::BID, 5, "TraderS9", 101.0);
+    orderBook.addOrder(bigBid);
+    EXPECT_TRUE(orderBook.getActiveAsks().empty());
+    for (const auto &event : eventLogger->getEventLog())
+    {
+        auto orderEvent = std::dynamic_pointer_cast<OrderEvent>(event);
+        if (orderEvent && orderEvent->getType() == EventType::ORDER_CANCELLED && orderEvent->getOrder().getId() == askId)
+            cancelled = std::make_shared<Order>(orderEvent->getOrder());
+    }
+    ASSERT_NE(cancelled, nullptr);
+    EXPECT_EQ(cancelled->getInitialQuantity(), 6);
+    EXPECT_EQ(cancelled->getRemainingQuantity(), 0);
+    EXPECT_EQ(cancelled->getStatus(), OrderStatus::CANCELLED);
+}
+
+TEST_F(ActiveOrderTest, SelfTradeDecrementBothCountsIcebergHiddenQuantity)
+{
+    orderBook.setSelfTradePrevention(SelfTradePrevention::DECREMENT_BOTH);
+
+    auto icebergPayload = IcebergOrder(OrderSide::ASK, 10, "TraderS8", 101.0, 3, 7);
+    orderBook.addOrder(icebergPayload);
+    auto bidPayload = LimitOrder(OrderSide::BID, 5, "TraderS8", 101.0);
+    orderBook.addOrder(bidPayload);
+
+    EXPECT_TRUE(orderBook.getTrades(0, -1).empty());
+    auto iceberg = orderBook.getBestAsk();
+    EXPECT_EQ(iceberg.getRemainingQuantity(), 3);
+    EXPECT_EQ(iceberg.getHiddenQuantity(), 2);
+}
+
+TEST_F(ActiveOrderTest, FOKOrderIgnoresOwnLiquidity)
+{
+    auto ownPayload = LimitOrder(OrderSide::ASK, 10, "TraderFOK2", 100.0);
+    auto otherPayload = LimitOrder(OrderSide::ASK, 5, "TraderASK4", 100.0);
+    orderBook.addOrder(ownPayload);
+    orderBook.addOrder(otherPayload);
+
+    auto tooLargePayload = FOKOrder(OrderSide::BID, 10, "TraderFOK2", 100.0);
+    orderBook.addOrder(tooLargePayload);
+    EXPECT_TRUE(orderBook.getTrades(0, -1).empty());
+    EXPECT_EQ(orderBook.getDepth(OrderSide::ASK)[0].quantity, 15);
+
+    auto fillablePayload = FOKOrder(OrderSide::BID, 5, "TraderFOK2", 100.0);
+    orderBook.addOrder(fillablePayload);
+    EXPECT_EQ(orderBook.getTrades(0, -1).size(), 1);
+    EXPECT_EQ(orderBook.getDepth(OrderSide::ASK)[0].quantity, 10);
+}
+
+TEST_F(ActiveOrderTest, BatchReportsEachOrder)
+{
+    traderService->setTrader("TraderB3", std::make_shared<MockTrader>("TraderB3", 0, 0.0, 0.0, 0, 100.0));
+
+    std::vector<Order> batch = {
+        LimitOrder(OrderSide::ASK, 10, "TraderB1", 100.0),
+        LimitOrder(OrderSide::BID, 4, "TraderB2", 100.0),
+        LimitOrder(OrderSide::ASK, 5, "TraderB3", 99.0),
+    };
+    auto results = orderBook.addOrders(batch);
+
+    ASSERT_EQ(results.size(), 3);
+    ASSERT_TRUE(results[0].accepted());
+    ASSERT_TRUE(results[1].accepted());
+    EXPECT_FALSE(results[2].accepted());
+    EXPECT_FALSE(results[2].error.empty());
+
+    EXPECT_EQ(results[1].order->getStatus(), OrderStatus::FILLED);
+    EXPECT_EQ(orderBook.getTrades(0, -1).size(), 1);
+    EXPECT_EQ(orderBook.getBestAsk().getId(), results[0].order->getId());
+    EXPECT_EQ(orderBook.getBestAsk().getRemainingQuantity(), 6);
+}
+
+TEST_F(ActiveOrderTest, CommitBeforeReturnPersistsFills)
+{
+    PersistenceOptions options;
+    options.flushInterval = std::chrono::hours(1);
+    options.durability = Durability::COMMIT_BEFORE_RETURN;
+
+    auto storage = std::make_shared<SqliteDatabase>(":memory:");
+    OrderBook book(storage, eventLogger, marketService, riskService, traderService, options);
+
+    auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderDurable1", 100.0);
+    auto ask = book.addOrder(askPayload);
+    auto bidPayload = LimitOrder(OrderSide::BID, 4, "TraderDurable2", 100.0);
+    book.addOrder(bidPayload);
+
+    auto active = storage->orders()->getAllActive();
+    ASSERT_EQ(active.size(), 1);
+    EXPECT_EQ(active[0]->getId(), ask.getId());
+    EXPECT_EQ(active[0]->getRemainingQuantity(), 6);
+    EXPECT_GE(book.getPersistenceStats().batches, 2);
+}
+
+TEST_F(ActiveOrderTest, OlderTradesReadWithoutFlushOnceStored)
+{
+    PersistenceOptions options;
+    options.flushInterval = std::chrono::hours(1);
+    options.maxBatchSize = 1 << 20;
+
+    auto storage = std::make_shared<SqliteDatabase>(":memory:");
+    OrderBook book(storage, eventLogger, marketService, riskService, traderService, options);
+
+    // More trades than are held in memory, none of them committed yet.
+    for (int i = 0; i < 10050; ++i)
+    {
+        std::string seller = (i % 2 == 0) ? "TraderStored1" : "TraderStored2";
+        std::string buyer = (i % 2 == 0) ? "TraderStored2" : "TraderStored1";
+        auto ask = LimitOrder(OrderSide::ASK, 1, seller, 100.0);
+        book.addOrder(ask);
+        auto bid = LimitOrder(OrderSide::BID, 1, buyer, 100.0);
+        book.addOrder(bid);
+    }
+    EXPECT_EQ(book.getPersistenceStats().batches, 0);
+
+    // The oldest trades have left memory but not reached storage, so reading them has to commit them first.
+    auto first = book.getTradesBefore(11, 10);
+    ASSERT_EQ(first.size(), 10);
+    EXPECT_EQ(first.front().getId(), 10);
+    EXPECT_EQ(book.getPersistenceStats().batches, 1);
+
+    // Once they are stored, newer changes still queued do not make reading them commit again.
+    auto ask = LimitOrder(OrderSide::ASK, 1, "TraderStored1", 100.0);
+    book.addOrder(ask);
+    auto again = book.getTradesBefore(11, 10);
+    ASSERT_EQ(again.size(), 10);
+    EXPECT_EQ(again.front().getId(), 10);
+    EXPECT_EQ(book.getPersistenceStats().batches, 1);
+}
+
+// Fails its first commit, as a busy or full database would.
+class FlakyDatabase : public SqliteDatabase
+{
+public:
+    FlakyDatabase() : SqliteDatabase(":memory:") {}
+
+    void commitTransaction() override
+    {
+        if (failuresLeft > 0)
+        {
+            --failuresLeft;
+            throw std::runtime_error("database is locked");
+        }
+        SqliteDatabase::commitTransaction();
+    }
+
+    int failuresLeft = 1;
+};
+
+TEST_F(ActiveOrderTest, FailedCommitIsRetried)
+{
+    PersistenceOptions options;
+    options.flushInterval = std::chrono::hours(1);
+    options.durability = Durability::COMMIT_BEFORE_RETURN;
+
+    auto storage = std::make_shared<FlakyDatabase>();
+    OrderBook book(storage, eventLogger, marketService, riskService, traderService, options);
+
+    auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderDurable1", 100.0);
+    auto ask = book.addOrder(askPayload);
+
+    auto active = storage->orders()->getAllActive();
+    ASSERT_EQ(active.size(), 1);
+    EXPECT_EQ(active[0]->getId(), ask.getId());
+    EXPECT_EQ(book.getPersistenceStats().failedCommits, 1);
+}
+
+TEST_F(ActiveOrderTest, CommitBeforeReturnPersistsBatch)
+{
+    PersistenceOptions options;
+    options.flushInterval = std::chrono::hours(1);
+    options.durability = Durability::COMMIT_BEFORE_RETURN;
+
+    auto storage = std::make_shared<SqliteDatabase>(":memory:");
+    OrderBook book(storage, eventLogger, marketService, riskService, traderService, options);
+
+    std::vector<Order> batch = {
+        LimitOrder(OrderSide::ASK, 10, "TraderDurable1", 100.0),
+        LimitOrder(OrderSide::BID, 4, "TraderDurable2", 100.0),
+    };
+    auto results = book.addOrders(batch);
+
+    ASSERT_EQ(results.size(), 2);
+    ASSERT_TRUE(results[0].accepted());
+    auto active = storage->orders()->getAllActive();
+    ASSERT_EQ(active.size(), 1);
+    EXPECT_EQ(active[0]->getId(), results[0].order->getId());
+    EXPECT_EQ(active[0]->getRemainingQuantity(), 6);
+    EXPECT_EQ(storage->trades()->getLastId(), 1);
+}
+
+TEST_F(ActiveOrderTest, IdsContinueAfterRestart)
+{
+    auto storage = std::make_shared<SqliteDatabase>(":memory:");
+    int lastOrderId = 0;
+    int lastTradeId = 0;
+    {
+        OrderBook before(storage, eventLogger, marketService, riskService, traderService);
+        auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderSequence1", 100.0);
+        before.addOrder(askPayload);
+        auto bidPayload = LimitOrder(OrderSide::BID, 4, "TraderSequence2", 100.0);
+        lastOrderId = before.addOrder(bidPayload).getId();
+        lastTradeId = before.getTrades(0, 1).front().getId();
+    }
+
+    EXPECT_EQ(storage->orders()->getLastId(), lastOrderId);
+    EXPECT_EQ(storage->trades()->getLastId(), lastTradeId);
+
+    OrderBook after(storage, eventLogger, marketService, riskService, traderService);
+    auto bidPayload = LimitOrder(OrderSide::BID, 2, "TraderSequence2", 100.0);
+    auto bid = after.addOrder(bidPayload);
+
+    EXPECT_EQ(bid.getId(), lastOrderId + 1);
+    EXPECT_EQ(after.getTrades(0, 1).front().getId(), lastTradeId + 1);
+    EXPECT_EQ(after.getBestAsk().getRemainingQuantity(), 4);
+}
+
+TEST_F(ActiveOrderTest, TraderPositionsSurviveRestart)
+{
+    auto storage = std::make_shared<SqliteDatabase>(":memory:");
+    TraderState buyer;
+    TraderState seller;
+    {
+        auto traders = std::make_shared<TraderService>();
+        OrderBook before(storage, eventLogger, std::make_shared<MarketService>(traders), riskService, traders);
+        auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderPosition1", 100.0);
+        before.addOrder(askPayload);
+        auto bidPayload = LimitOrder(OrderSide::BID, 4, "TraderPosition2", 100.0);
+        before.addOrder(bidPayload);
+
+        buyer = traders->getTrader("TraderPosition2")->getState();
+        seller = traders->getTrader("TraderPosition1")->getState();
+    }
+
+    auto traders = std::make_shared<TraderService>();
+    OrderBook after(storage, eventLogger, std::make_shared<MarketService>(traders), riskService, traders);
+
+    auto restoredBuyer = traders->getTrader("TraderPosition2")->getState();
+    auto restoredSeller = traders->getTrader("TraderPosition1")->getState();
+    EXPECT_EQ(restoredBuyer.traderName, buyer.traderName);
+    ASSERT_EQ(restoredBuyer.lots.size(), buyer.lots.size());
+    EXPECT_EQ(restoredBuyer.lots.back().quantity, 4);
+    EXPECT_DOUBLE_EQ(restoredBuyer.lots.back().price, 100.0);
+    EXPECT_EQ(restoredSeller.reservedInventory, 10);
+    EXPECT_EQ(restoredSeller.totalClosedTrades, 1);
+    EXPECT_DOUBLE_EQ(restoredSeller.realizedPnL, seller.realizedPnL);
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
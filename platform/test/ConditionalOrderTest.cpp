@@ -1,4 +1,5 @@
 #include "OrderBook.hpp"
+#include "database/SqliteDatabase.hpp"
 #include "mocks/MockDatabase.hpp"
 #include "mocks/MockRiskService.hpp"
 
@@ -110,8 +111,199 @@ TEST_F(ConditionalOrderTest, TrailingStopOrderTriggered)
     EXPECT_NE(it, events.end());
 }
 
+TEST_F(ConditionalOrderTest, OnlyCrossedStopsTrigger)
+{
+    auto nearPayload = StopOrder(OrderSide::ASK, 10, "TraderStopRange", 98.0);
+    auto farPayload = StopOrder(OrderSide::ASK, 10, "TraderStopRange", 90.0);
+    auto buyPayload = StopLimitOrder(OrderSide::BID, 10, "TraderStopRange", 105.0, 106.0);
+    auto nearOrder = orderBook.addOrder(nearPayload);
+    auto farOrder = orderBook.addOrder(farPayload);
+    auto buyOrder = orderBook.addOrder(buyPayload);
+
+    orderBook.updateMarketPrice(95.0, 0.0);
+
+    auto asks = orderBook.getConditionalAsks();
+    auto bids = orderBook.getConditionalBids();
+    ASSERT_EQ(asks.size(), 1);
+    EXPECT_EQ(asks[0].getId(), farOrder.getId());
+    ASSERT_EQ(bids.size(), 1);
+    EXPECT_EQ(bids[0].getId(), buyOrder.getId());
+}
+
+TEST_F(ConditionalOrderTest, CancelledStopNeverTriggers)
+{
+    auto askPayload = StopOrder(OrderSide::ASK, 10, "TraderStopCancel", 95.0);
+    auto askOrder = orderBook.addOrder(askPayload);
+
+    EXPECT_TRUE(orderBook.cancelOrder(askOrder.getId()));
+    EXPECT_FALSE(orderBook.cancelOrder(askOrder.getId()));
+
+    orderBook.updateMarketPrice(90.0, 0.0);
+
+    auto events = orderBook.getEventLogger().getEventLog();
+    auto it = std::find_if(events.begin(), events.end(), [](const std::shared_ptr<Event> &event)
+                           { return event->getType() == EventType::ORDER_TRIGGERED; });
+    EXPECT_EQ(it, events.end());
+    EXPECT_TRUE(orderBook.getConditionalAsks().empty());
+}
+
+TEST_F(ConditionalOrderTest, TrailingStopFollowsMarket)
+{
+    auto bidPayload = TrailingStopOrder(OrderSide::BID, 10, "TraderTrailingBid", 2.0, 100.0);
+    auto bidOrder = orderBook.addOrder(bidPayload);
+
+    orderBook.updateMarketPrice(97.0, 0.0);
+    orderBook.updateMarketPrice(98.0, 0.0);
+
+    auto bids = orderBook.getConditionalBids();
+    ASSERT_EQ(bids.size(), 1);
+    EXPECT_EQ(bids[0].getBestPrice(), Price::fromDouble(97.0));
+
+    orderBook.updateMarketPrice(99.0, 0.0);
+    EXPECT_TRUE(orderBook.getConditionalBids().empty());
+}
+
+TEST_F(ConditionalOrderTest, StopCascadeRespectsLimit)
+{
+    orderBook.setCascadeLimit(1);
+
+    auto firstPayload = StopOrder(OrderSide::ASK, 10, "TraderCascade", 95.0);
+    auto secondPayload = StopOrder(OrderSide::ASK, 10, "TraderCascade", 94.0);
+    orderBook.addOrder(firstPayload);
+    orderBook.addOrder(secondPayload);
+
+    orderBook.updateMarketPrice(90.0, 0.0);
+
+    auto stats = orderBook.getCascadeStats();
+    EXPECT_EQ(stats.lastSize, 1);
+    EXPECT_EQ(stats.lastDepth, 1);
+    EXPECT_EQ(stats.deferred, 1);
+    ASSERT_EQ(orderBook.getConditionalAsks().size(), 1);
+    EXPECT_EQ(orderBook.getConditionalAsks()[0].getStatus(), OrderStatus::UNFILLED);
+
+    orderBook.setCascadeLimit(10);
+    orderBook.updateMarketPrice(90.0, 0.0);
+    stats = orderBook.getCascadeStats();
+    EXPECT_EQ(stats.lastSize, 1);
+    EXPECT_EQ(stats.cascades, 2);
+    EXPECT_TRUE(orderBook.getConditionalAsks().empty());
+}
+
+TEST_F(ConditionalOrderTest, DeferredStopCanBeCancelled)
+{
+    orderBook.setCascadeLimit(1);
+
+    auto firstPayload = StopOrder(OrderSide::ASK, 10, "TraderDeferred", 95.0);
+    auto secondPayload = StopOrder(OrderSide::ASK, 10, "TraderDeferred", 94.0);
+    orderBook.addOrder(firstPayload);
+    auto deferred = orderBook.addOrder(secondPayload);
+
+    orderBook.updateMarketPrice(90.0, 0.0);
+    EXPECT_TRUE(orderBook.cancelOrder(deferred.getId()));
+
+    orderBook.updateMarketPrice(90.0, 0.0);
+    EXPECT_EQ(orderBook.getCascadeStats().cascades, 1);
+    EXPECT_TRUE(orderBook.getConditionalAsks().empty());
+}
+
+TEST_F(ConditionalOrderTest, StopTriggeredByTradePrint)
+{
+    auto stopPayload = StopOrder(OrderSide::BID, 5, "TraderStopPrint", 102.0);
+    orderBook.addOrder(stopPayload);
+
+    auto nearPayload = LimitOrder(OrderSide::ASK, 5, "TraderPrintAsk", 101.0);
+    auto farPayload = LimitOrder(OrderSide::ASK, 5, "TraderPrintAsk", 102.0);
+    auto restingPayload = LimitOrder(OrderSide::ASK, 5, "TraderPrintAsk", 103.0);
+    orderBook.addOrder(nearPayload);
+    orderBook.addOrder(farPayload);
+    orderBook.addOrder(restingPayload);
+
+    auto sweepPayload = LimitOrder(OrderSide::BID, 10, "TraderPrintBid", 102.0);
+    orderBook.addOrder(sweepPayload);
+
+    EXPECT_TRUE(orderBook.getConditionalBids().empty());
+    EXPECT_EQ(orderBook.getCascadeStats().lastDepth, 1);
+    EXPECT_EQ(orderBook.getTrades(0, -1).size(), 3);
+    EXPECT_THROW(orderBook.getBestAsk(), std::runtime_error);
+}
+
+TEST_F(ConditionalOrderTest, StopCrossedOnlyMidSweepIsTriggered)
+{
+    marketService->updatePrice(Price::fromDouble(103.0));
+
+    auto stopPayload = StopOrder(OrderSide::ASK, 5, "TraderMidSweepStop", 100.5);
+    orderBook.addOrder(stopPayload);
+    auto supportPayload = LimitOrder(OrderSide::BID, 5, "TraderMidSweepBid", 95.0);
+    orderBook.addOrder(supportPayload);
+
+    auto lowPayload = LimitOrder(OrderSide::ASK, 5, "TraderMidSweepAsk", 100.0);
+    auto highPayload = LimitOrder(OrderSide::ASK, 5, "TraderMidSweepAsk", 101.0);
+    orderBook.addOrder(lowPayload);
+    orderBook.addOrder(highPayload);
+
+    // The sweep prints at 100 then 101. Only the first print crosses the stop; the price it ends on does not.
+    auto sweepPayload = LimitOrder(OrderSide::BID, 10, "TraderMidSweepBuy", 101.0);
+    orderBook.addOrder(sweepPayload);
+
+    EXPECT_TRUE(orderBook.getConditionalAsks().empty());
+    auto trades = orderBook.getTrades(0, -1);
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[0].getPrice(), Price::fromDouble(95.0));
+    EXPECT_EQ(trades[0].getSellOrderType(), OrderType::MARKET);
+}
+
+TEST_F(ConditionalOrderTest, ConditionalOrdersSurviveRestart)
+{
+    auto storage = std::make_shared<SqliteDatabase>(":memory:");
+    int stopId = 0;
+    int trailingId = 0;
+    {
+        OrderBook before(storage, eventLogger, marketService, riskService, traderService);
+        auto stopPayload = StopOrder(OrderSide::ASK, 10, "TraderRestart", 95.0);
+        auto triggeredPayload = StopOrder(OrderSide::ASK, 10, "TraderRestart", 100.0);
+        auto trailingPayload = TrailingStopOrder(OrderSide::ASK, 10, "TraderRestart", 2.0, 100.0);
+        stopId = before.addOrder(stopPayload).getId();
+        before.addOrder(triggeredPayload);
+        trailingId = before.addOrder(trailingPayload).getId();
+
+        before.updateMarketPrice(101.0, 0.0);
+        before.updateMarketPrice(99.5, 0.0);
+        before.saveTrailingStops();
+    }
+
+    OrderBook after(storage, eventLogger, marketService, riskService, traderService);
+    auto asks = after.getConditionalAsks();
+
+    ASSERT_EQ(asks.size(), 2);
+    EXPECT_EQ(asks[0].getId(), stopId);
+    EXPECT_EQ(asks[1].getId(), trailingId);
+    EXPECT_EQ(asks[1].getBestPrice(), Price::fromDouble(101.0));
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
+
+TEST_F(ConditionalOrderTest, DeferredStopSurvivesRestart)
+{
+    auto storage = std::make_shared<SqliteDatabase>(":memory:");
+    int deferredId = 0;
+    {
+        OrderBook before(storage, eventLogger, marketService, riskService, traderService);
+        before.setCascadeLimit(1);
+        auto firstPayload = StopOrder(OrderSide::ASK, 10, "TraderDeferredRestart", 95.0);
+        auto secondPayload = StopOrder(OrderSide::ASK, 10, "TraderDeferredRestart", 94.0);
+        before.addOrder(firstPayload);
+        deferredId = before.addOrder(secondPayload).getId();
+
+        before.updateMarketPrice(90.0, 0.0);
+    }
+
+    OrderBook after(storage, eventLogger, marketService, riskService, traderService);
+    auto asks = after.getConditionalAsks();
+
+    ASSERT_EQ(asks.size(), 1);
+    EXPECT_EQ(asks[0].getId(), deferredId);
+}
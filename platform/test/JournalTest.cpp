@@ -0,0 +1,385 @@
+#include "OrderBook.hpp"
+#include "database/JournalDatabase.hpp"
+#include "database/SqliteDatabase.hpp"
+#include "mocks/MockRiskService.hpp"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+
+class JournalTest : public ::testing::Test
+{
+protected:
+    std::string directory;
+    std::shared_ptr<EventLogger> eventLogger;
+    std::shared_ptr<MockTraderService> traderService;
+    std::shared_ptr<MockRiskService> riskService;
+    std::shared_ptr<MarketService> marketService;
+
+    JournalTest()
+        : directory((std::filesystem::temp_directory_path() /
+                     ("midas-journal-" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+                        .string()),
+          eventLogger(std::make_shared<EventLogger>()),
+          traderService(std::make_shared<MockTraderService>()),
+          riskService(std::make_shared<MockRiskService>(eventLogger, traderService)),
+          marketService(std::make_shared<MarketService>(traderService))
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    ~JournalTest() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(JournalTest, BookRebuiltFromJournal)
+{
+    int askId = 0;
+    int stopId = 0;
+    {
+        auto storage = std::make_shared<JournalDatabase>(directory);
+        OrderBook before(storage, eventLogger, marketService, riskService, traderService);
+        auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderJournal1", 100.0);
+        askId = before.addOrder(askPayload).getId();
+        auto bidPayload = LimitOrder(OrderSide::BID, 4, "TraderJournal2", 100.0);
+        before.addOrder(bidPayload);
+        auto stopPayload = StopOrder(OrderSide::ASK, 5, "TraderJournal1", 90.0);
+        stopId = before.addOrder(stopPayload).getId();
+    }
+
+    auto storage = std::make_shared<JournalDatabase>(directory);
+    OrderBook after(storage, eventLogger, marketService, riskService, traderService);
+
+    EXPECT_EQ(after.getBestAsk().getId(), askId);
+    EXPECT_EQ(after.getBestAsk().getRemainingQuantity(), 6);
+    ASSERT_EQ(after.getConditionalAsks().size(), 1);
+    EXPECT_EQ(after.getConditionalAsks()[0].getId(), stopId);
+    ASSERT_EQ(after.getTrades(0, -1).size(), 1);
+    EXPECT_EQ(after.getTrades(0, -1)[0].getQuantity(), 4);
+    EXPECT_EQ(storage->orders()->getLastId(), stopId);
+}
+
+TEST_F(JournalTest, RolledBackBatchIsNotRecovered)
+{
+    {
+        JournalDatabase storage(directory);
+        storage.beginTransaction();
+        auto kept = LimitOrder(OrderSide::BID, 10, "TraderJournal1", 99.0);
+        kept.setId(1);
+        storage.orders()->insert(kept);
+        storage.commitTransaction();
+
+        storage.beginTransaction();
+        auto dropped = LimitOrder(OrderSide::BID, 10, "TraderJournal1", 98.0);
+        dropped.setId(2);
+        storage.orders()->insert(dropped);
+        storage.rollbackTransaction();
+    }
+
+    JournalDatabase storage(directory);
+    auto active = storage.orders()->getAllActive();
+    ASSERT_EQ(active.size(), 1);
+    EXPECT_EQ(active[0]->getId(), 1);
+    EXPECT_EQ(active[0]->getPrice(), Price::fromDouble(99.0));
+}
+
+TEST_F(JournalTest, TornTailIsDiscarded)
+{
+    std::string segment = (std::filesystem::path(directory) / "journal-000001.log").string();
+    size_t tornAt = 0;
+    {
+        JournalDatabase storage(directory);
+        auto first = LimitOrder(OrderSide::ASK, 10, "TraderJournal1", 101.0);
+        first.setId(1);
+        storage.orders()->insert(first);
+
+        std::ifstream in(segment, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        tornAt = bytes.find_last_not_of('\0') + 1;
+
+        auto second = LimitOrder(OrderSide::ASK, 10, "TraderJournal1", 102.0);
+        second.setId(2);
+        storage.orders()->insert(second);
+    }
+
+    // Corrupt the second record's payload, as a write cut short by a crash would.
+    {
+        std::fstream file(segment, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(tornAt + 12));
+        file.put('\x7f');
+    }
+
+    {
+        JournalDatabase storage(directory);
+        ASSERT_EQ(storage.orders()->getAllActive().size(), 1);
+        EXPECT_EQ(storage.orders()->getLastId(), 1);
+
+        auto third = LimitOrder(OrderSide::ASK, 10, "TraderJournal1", 103.0);
+        third.setId(2);
+        storage.orders()->insert(third);
+    }
+
+    JournalDatabase storage(directory);
+    auto active = storage.orders()->getAllActive();
+    ASSERT_EQ(active.size(), 2);
+    EXPECT_EQ(active[1]->getPrice(), Price::fromDouble(103.0));
+}
+
+TEST_F(JournalTest, RecordsSpanSegments)
+{
+    {
+        JournalDatabase storage(directory, {}, 4096);
+        for (int id = 1; id <= 200; ++id)
+        {
+            auto order = LimitOrder(OrderSide::BID, id, "TraderJournal1", 90.0);
+            order.setId(id);
+            storage.orders()->insert(order);
+        }
+    }
+
+    EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(directory) / "journal-000002.log"));
+
+    JournalDatabase storage(directory, {}, 4096);
+    auto active = storage.orders()->getAllActive();
+    ASSERT_EQ(active.size(), 200);
+    EXPECT_EQ(active.back()->getInitialQuantity(), 200);
+}
+
+TEST_F(JournalTest, CheckpointSkipsEarlierRecords)
+{
+    std::string segment = (std::filesystem::path(directory) / "journal-000001.log").string();
+    {
+        JournalDatabase storage(directory);
+        auto first = LimitOrder(OrderSide::BID, 10, "TraderJournal1", 99.0);
+        first.setId(1);
+        storage.orders()->insert(first);
+        storage.checkpoint();
+
+        auto second = LimitOrder(OrderSide::BID, 10, "TraderJournal1", 98.0);
+        second.setId(2);
+        storage.orders()->insert(second);
+    }
+
+    // Damage the first record. Replaying from the start would stop there; from the checkpoint it is never read.
+    {
+        std::fstream file(segment, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8 + 12);
+        file.put('\x7f');
+    }
+
+    JournalDatabase storage(directory);
+    auto active = storage.orders()->getAllActive();
+    ASSERT_EQ(active.size(), 2);
+    EXPECT_EQ(active[0]->getPrice(), Price::fromDouble(99.0));
+    EXPECT_EQ(active[1]->getPrice(), Price::fromDouble(98.0));
+    EXPECT_EQ(storage.orders()->getLastId(), 2);
+}
+
+TEST_F(JournalTest, OtherFormatVersionIsRefused)
+{
+    std::string segment = (std::filesystem::path(directory) / "journal-000001.log").string();
+    {
+        JournalDatabase storage(directory);
+        auto order = LimitOrder(OrderSide::BID, 10, "TraderJournal1", 99.0);
+        order.setId(1);
+        storage.orders()->insert(order);
+    }
+
+    // The version byte follows the magic; records of another version must not be decoded as this one.
+    {
+        std::fstream file(segment, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(7);
+        file.put('\x01');
+    }
+
+    EXPECT_THROW(JournalDatabase storage(directory), std::runtime_error);
+}
+
+TEST_F(JournalTest, SnapshotRestoresPositions)
+{
+    std::string snapshotPath = directory + ".snapshot";
+    TraderState buyer;
+    TraderState seller;
+    Price marketPrice;
+    {
+        auto traders = std::make_shared<TraderService>();
+        auto market = std::make_shared<MarketService>(traders);
+        auto storage = std::make_shared<JournalDatabase>(directory);
+        OrderBook before(storage, eventLogger, market, riskService, traders);
+
+        auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderSnapshotSell", 100.0);
+        before.addOrder(askPayload);
+        auto firstBid = LimitOrder(OrderSide::BID, 4, "TraderSnapshotBuy", 100.0);
+        before.addOrder(firstBid);
+        before.saveSnapshot(snapshotPath);
+
+        // Traded after the snapshot, so it has to be replayed from storage.
+        auto secondAsk = LimitOrder(OrderSide::ASK, 2, "TraderSnapshotSell", 99.0);
+        before.addOrder(secondAsk);
+        auto secondBid = LimitOrder(OrderSide::BID, 2, "TraderSnapshotBuy", 99.0);
+        before.addOrder(secondBid);
+
+        buyer = traders->getTrader("TraderSnapshotBuy")->getState();
+        seller = traders->getTrader("TraderSnapshotSell")->getState();
+        marketPrice = market->getCurrentPrice();
+    }
+
+    auto traders = std::make_shared<TraderService>();
+    auto market = std::make_shared<MarketService>(traders);
+    auto storage = std::make_shared<JournalDatabase>(directory);
+    OrderBook after(storage, eventLogger, market, riskService, traders);
+    ASSERT_TRUE(after.loadSnapshot(snapshotPath));
+    std::filesystem::remove(snapshotPath);
+
+    auto restoredBuyer = traders->getTrader("TraderSnapshotBuy");
+    auto restoredSeller = traders->getTrader("TraderSnapshotSell");
+    EXPECT_EQ(restoredBuyer->getInventory(), std::accumulate(buyer.lots.begin(), buyer.lots.end(), 0, [](int total, const Lot &lot)
+                                                             { return total + lot.quantity; }));
+    EXPECT_EQ(restoredBuyer->getName(), buyer.traderName);
+    EXPECT_EQ(restoredSeller->getState().lots.size(), seller.lots.size());
+    EXPECT_DOUBLE_EQ(restoredSeller->getRealizedPnL(), seller.realizedPnL);
+    EXPECT_EQ(restoredSeller->getTotalClosedTrades(), 2);
+    EXPECT_EQ(market->getCurrentPrice(), marketPrice);
+}
+
+TEST_F(JournalTest, TraderPositionsRestoredWithoutReplay)
+{
+    TraderState seller;
+    {
+        auto traders = std::make_shared<TraderService>();
+        auto storage = std::make_shared<JournalDatabase>(directory);
+        OrderBook before(storage, eventLogger, std::make_shared<MarketService>(traders), riskService, traders);
+
+        auto askPayload = LimitOrder(OrderSide::ASK, 10, "TraderStoredSell", 100.0);
+        before.addOrder(askPayload);
+        auto firstBid = LimitOrder(OrderSide::BID, 4, "TraderStoredBuy", 100.0);
+        before.addOrder(firstBid);
+        // Checkpoints the journal, so the first trade's positions come from the checkpoint and the second's
+        // from the records after it.
+        before.saveSnapshot(directory + ".snapshot");
+        std::filesystem::remove(directory + ".snapshot");
+
+        auto secondBid = LimitOrder(OrderSide::BID, 3, "TraderStoredBuy", 100.0);
+        before.addOrder(secondBid);
+        seller = traders->getTrader("TraderStoredSell")->getState();
+    }
+
+    auto storage = std::make_shared<JournalDatabase>(directory);
+    ASSERT_EQ(storage->traders()->getAll().size(), 2);
+
+    auto traders = std::make_shared<TraderService>();
+    OrderBook after(storage, eventLogger, std::make_shared<MarketService>(traders), riskService, traders);
+    auto restoredSeller = traders->getTrader("TraderStoredSell")->getState();
+    EXPECT_EQ(restoredSeller.totalClosedTrades, 2);
+    EXPECT_EQ(restoredSeller.lots.size(), seller.lots.size());
+    EXPECT_DOUBLE_EQ(restoredSeller.realizedPnL, seller.realizedPnL);
+    EXPECT_EQ(traders->getTrader("TraderStoredBuy")->getState().lots.back().quantity, 3);
+}
+
+TEST_F(JournalTest, OlderTradesPagedFromStorage)
+{
+    StorageOptions options;
+    options.synchronous = SyncMode::OFF;
+    auto storage = std::make_shared<JournalDatabase>(directory, options);
+    OrderBook book(storage, eventLogger, marketService, riskService, traderService);
+
+    // More trades than are held in memory, so the oldest have to come back from the journal.
+    const int tradeCount = 10050;
+    for (int i = 0; i < tradeCount; ++i)
+    {
+        // Alternate the seller so neither trader runs out of inventory.
+        std::string seller = (i % 2 == 0) ? "TraderJournal1" : "TraderJournal2";
+        std::string buyer = (i % 2 == 0) ? "TraderJournal2" : "TraderJournal1";
+        auto ask = LimitOrder(OrderSide::ASK, 1, seller, 100.0);
+        book.addOrder(ask);
+        auto bid = LimitOrder(OrderSide::BID, 1, buyer, 100.0);
+        book.addOrder(bid);
+    }
+
+    auto all = book.getTrades(0, -1);
+    ASSERT_EQ(all.size(), tradeCount);
+    for (size_t i = 1; i < all.size(); ++i)
+        ASSERT_EQ(all[i].getId(), all[i - 1].getId() - 1);
+
+    auto offsetPage = book.getTrades(tradeCount - 60, 20);
+    ASSERT_EQ(offsetPage.size(), 20);
+    EXPECT_EQ(offsetPage.front().getId(), all[tradeCount - 60].getId());
+
+    // A keyset page that starts in memory and runs on into storage.
+    int cursor = all[9990].getId();
+    auto page = book.getTradesBefore(cursor, 30);
+    ASSERT_EQ(page.size(), 30);
+    for (size_t i = 0; i < page.size(); ++i)
+        EXPECT_EQ(page[i].getId(), cursor - 1 - static_cast<int>(i));
+
+    auto last = book.getTradesBefore(all.back().getId() + 2, 10);
+    EXPECT_EQ(last.size(), 2);
+}
+
+TEST_F(JournalTest, OlderTradeReadsMatchSqlite)
+{
+    StorageOptions options;
+    options.synchronous = SyncMode::OFF;
+    JournalDatabase journal(directory, options, 64 << 10);
+    SqliteDatabase sqlite(":memory:");
+
+    auto buy = LimitOrder(OrderSide::BID, 1, "TraderJournal1", 100.0);
+    buy.setId(1);
+    auto sell = LimitOrder(OrderSide::ASK, 1, "TraderJournal2", 100.0);
+    sell.setId(2);
+
+    // Enough trades to push the oldest out of memory and across several journal segments.
+    const int tradeCount = static_cast<int>(JournalStore::RECENT_TRADES) + 500;
+    sqlite.beginTransaction();
+    for (Database *storage : std::initializer_list<Database *>{&journal, &sqlite})
+    {
+        storage->orders()->insert(buy);
+        storage->orders()->insert(sell);
+        for (int id = 1; id <= tradeCount; ++id)
+        {
+            Trade trade(1, 2, OrderType::LIMIT, OrderType::LIMIT, id, Price::fromDouble(100.0));
+            trade.setId(id);
+            storage->trades()->insert(trade);
+        }
+    }
+    sqlite.commitTransaction();
+    ASSERT_TRUE(std::filesystem::exists(std::filesystem::path(directory) / "journal-000003.log"));
+
+    for (int beforeId : {tradeCount + 1, tradeCount - 20, 450, 30, 1})
+    {
+        auto expected = sqlite.trades()->getPage(beforeId, 100);
+        auto actual = journal.trades()->getPage(beforeId, 100);
+        ASSERT_EQ(expected.size(), static_cast<size_t>(std::min(100, beforeId - 1)));
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(expected[i].getId(), beforeId - 1 - static_cast<int>(i));
+            EXPECT_EQ(actual[i].getId(), expected[i].getId());
+            EXPECT_EQ(actual[i].getQuantity(), expected[i].getQuantity());
+        }
+    }
+
+    // Reading since a trade no longer in memory starts from the segment holding it, not the whole journal.
+    for (int afterId : {tradeCount - 10, 450, 0})
+    {
+        auto expected = sqlite.trades()->getSince(afterId);
+        auto actual = journal.trades()->getSince(afterId);
+        ASSERT_EQ(expected.size(), static_cast<size_t>(tradeCount - afterId));
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(actual[i].getId(), expected[i].getId());
+            EXPECT_EQ(actual[i].getQuantity(), expected[i].getQuantity());
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
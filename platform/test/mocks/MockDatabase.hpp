@@ -10,39 +10,46 @@
 class MockOrderRepository : public OrderRepository
 {
 public:
-    MockOrderRepository() : OrderRepository(nullptr), nextOrderId(1) {}
-
-    int create(const Order &order) override { return nextOrderId++; }
+    void insert(const Order &order) override {}
+    int getLastId() override { return 0; }
     void update(const Order &order) override {}
     std::vector<std::shared_ptr<Order>> getAllActive() override { return {}; }
-
-private:
-    int nextOrderId;
+    void forEachActiveConditional(const std::function<void(std::shared_ptr<Order>)> &visit) override {}
 };
 
 class MockTradeRepository : public TradeRepository
 {
 public:
-    MockTradeRepository() : TradeRepository(nullptr), nextTradeId(1) {}
-
-    int create(const Trade &trade) override { return nextTradeId++; }
+    void insert(const Trade &trade) override {}
+    int getLastId() override { return 0; }
     std::vector<Trade> getAll() override { return {}; }
+    TradeTotals getTotals() override { return {}; }
+    std::vector<Trade> getPage(int beforeId, int limit) override { return {}; }
+    std::vector<Trade> getSince(int afterId) override { return {}; }
+};
 
-private:
-    int nextTradeId;
+class MockTraderRepository : public TraderRepository
+{
+public:
+    void save(const TraderState &state) override {}
+    std::vector<TraderState> getAll() override { return {}; }
 };
 
 class MockDatabase : public Database
 {
 public:
-    MockDatabase() : Database("") {}
-
     std::shared_ptr<OrderRepository> orders() const override { return mockOrdersRepo; }
     std::shared_ptr<TradeRepository> trades() const override { return mockTradesRepo; }
+    std::shared_ptr<TraderRepository> traders() const override { return mockTradersRepo; }
+
+    void beginTransaction() override {}
+    void commitTransaction() override {}
+    void rollbackTransaction() override {}
 
 private:
     std::shared_ptr<OrderRepository> mockOrdersRepo = std::make_shared<MockOrderRepository>();
     std::shared_ptr<TradeRepository> mockTradesRepo = std::make_shared<MockTradeRepository>();
+    std::shared_ptr<TraderRepository> mockTradersRepo = std::make_shared<MockTraderRepository>();
 };
 
 #endif
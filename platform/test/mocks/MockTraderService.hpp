@@ -15,6 +15,11 @@ public:
         return traders[traderId];
     }
 
+    std::shared_ptr<Trader> getTraderByIndex(uint32_t traderIndex) override
+    {
+        return getTrader(TraderIds::name(traderIndex));
+    }
+
     void setTrader(const std::string &traderId, std::shared_ptr<MockTrader> trader)
     {
         traders[traderId] = trader;